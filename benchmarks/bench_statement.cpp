@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+// Microbenchmarks of the Statement wrapper: binds, column reads and preparing statements
+
+#include <string>
+#include <vector>
+
+#include "benchmark_database.hpp"
+
+namespace everest::db::sqlite::benchmarks {
+
+namespace {
+
+void create_rows(Connection& connection, int count) {
+    connection.execute_statement("CREATE TABLE rows (id INTEGER PRIMARY KEY, number INTEGER, name TEXT, data BLOB);");
+    auto transaction = connection.begin_transaction();
+    const std::vector<std::uint8_t> data(64, 0xAB);
+    for (int i = 0; i < count; i++) {
+        connection.execute("INSERT INTO rows (number, name, data) VALUES (?, ?, ?);", i,
+                           "name of row " + std::to_string(i), data);
+    }
+    transaction->commit();
+}
+
+void BM_BindInt(benchmark::State& state) {
+    BenchmarkDatabase database;
+    auto statement = database->new_statement("SELECT ?;");
+    int value = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(statement->bind_int(1, value++));
+    }
+}
+BENCHMARK(BM_BindInt);
+
+void BM_BindTextByName(benchmark::State& state) {
+    BenchmarkDatabase database;
+    auto statement = database->new_statement("SELECT :first, :second, :third;");
+    const std::string value = "some text value";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(statement->bind_text(":third", value));
+    }
+}
+BENCHMARK(BM_BindTextByName);
+
+void BM_BindTextByHandle(benchmark::State& state) {
+    BenchmarkDatabase database;
+    auto statement = database->new_statement("SELECT :first, :second, :third;");
+    auto third = statement->param(":third");
+    const std::string value = "some text value";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(third.bind_text(value));
+    }
+}
+BENCHMARK(BM_BindTextByHandle);
+
+void BM_BindBlob(benchmark::State& state) {
+    BenchmarkDatabase database;
+    auto statement = database->new_statement("SELECT ?;");
+    const std::vector<std::uint8_t> value(static_cast<std::size_t>(state.range(0)), 0xAB);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(statement->bind_blob(1, value));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_BindBlob)->Arg(64)->Arg(4096);
+
+/// \brief Reads column 0 of all rows with the column accessor selected by \p read
+template <typename Read> void read_all_rows(benchmark::State& state, const std::string& column, Read read) {
+    BenchmarkDatabase database;
+    create_rows(database.connection(), 1000);
+    auto statement = database->new_statement("SELECT " + column + " FROM rows;");
+    for (auto _ : state) {
+        while (statement->step() == SQLITE_ROW) {
+            read(*statement);
+        }
+        statement->reset();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 1000);
+}
+
+void BM_ColumnInt(benchmark::State& state) {
+    read_all_rows(state, "number",
+                  [](StatementInterface& statement) { benchmark::DoNotOptimize(statement.column_int(0)); });
+}
+BENCHMARK(BM_ColumnInt);
+
+void BM_ColumnText(benchmark::State& state) {
+    read_all_rows(state, "name",
+                  [](StatementInterface& statement) { benchmark::DoNotOptimize(statement.column_text(0)); });
+}
+BENCHMARK(BM_ColumnText);
+
+void BM_ColumnTextView(benchmark::State& state) {
+    read_all_rows(state, "name",
+                  [](StatementInterface& statement) { benchmark::DoNotOptimize(statement.column_text_view(0)); });
+}
+BENCHMARK(BM_ColumnTextView);
+
+void BM_ColumnBlob(benchmark::State& state) {
+    read_all_rows(state, "data",
+                  [](StatementInterface& statement) { benchmark::DoNotOptimize(statement.column_blob(0)); });
+}
+BENCHMARK(BM_ColumnBlob);
+
+void BM_ColumnVariantByName(benchmark::State& state) {
+    read_all_rows(state, "number, name",
+                  [](StatementInterface& statement) { benchmark::DoNotOptimize(statement.column_variant("name")); });
+}
+BENCHMARK(BM_ColumnVariantByName);
+
+void BM_RowRange(benchmark::State& state) {
+    BenchmarkDatabase database;
+    create_rows(database.connection(), 1000);
+    auto statement = database->new_statement("SELECT id, number, name FROM rows;");
+    for (auto _ : state) {
+        for (const auto& [id, number, name] : statement->rows<int64_t, int, std::string_view>()) {
+            benchmark::DoNotOptimize(id);
+            benchmark::DoNotOptimize(number);
+            benchmark::DoNotOptimize(name);
+        }
+        statement->reset();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 1000);
+}
+BENCHMARK(BM_RowRange);
+
+/// \brief Prepares the same statement over and over, with the statement cache disabled (0) or enabled (1)
+void BM_NewStatement(benchmark::State& state) {
+    BenchmarkDatabase database;
+    create_rows(database.connection(), 1);
+    database->set_statement_cache_capacity(state.range(0) == 0 ? 0 : DEFAULT_STATEMENT_CACHE_CAPACITY);
+    for (auto _ : state) {
+        auto statement = database->new_statement("SELECT number, name FROM rows WHERE id = ?;");
+        benchmark::DoNotOptimize(statement.get());
+    }
+}
+BENCHMARK(BM_NewStatement)->ArgName("cached")->Arg(0)->Arg(1);
+
+void BM_ExecuteStatement(benchmark::State& state) {
+    BenchmarkDatabase database;
+    create_rows(database.connection(), 1);
+    int value = 0;
+    for (auto _ : state) {
+        database->execute_statement("UPDATE rows SET number = " + std::to_string(value++) + " WHERE id = 1;");
+    }
+}
+BENCHMARK(BM_ExecuteStatement);
+
+void BM_Execute(benchmark::State& state) {
+    BenchmarkDatabase database;
+    create_rows(database.connection(), 1);
+    int value = 0;
+    for (auto _ : state) {
+        database->execute("UPDATE rows SET number = ? WHERE id = 1;", value++);
+    }
+}
+BENCHMARK(BM_Execute);
+
+} // namespace
+
+} // namespace everest::db::sqlite::benchmarks
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+// Benchmarks of commit latency, bulk loads and schema migrations, parameterized over the database configurations
+
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <everest/database/sqlite/batch_writer.hpp>
+#include <everest/database/sqlite/schema_updater.hpp>
+
+#include "benchmark_database.hpp"
+
+namespace everest::db::sqlite::benchmarks {
+
+namespace {
+
+/// \brief One small write per transaction, which is dominated by journal writes and syncs
+void BM_TransactionCommit(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    database->execute_statement("CREATE TABLE counter (id INTEGER PRIMARY KEY, value INTEGER);");
+    database->execute_statement("INSERT INTO counter VALUES (1, 0);");
+    for (auto _ : state) {
+        auto transaction = database->begin_transaction();
+        database->execute("UPDATE counter SET value = value + 1 WHERE id = 1;");
+        transaction->commit();
+    }
+}
+BENCHMARK(BM_TransactionCommit)->Apply(database_configurations);
+
+using BulkRow = std::tuple<int, std::string, double>;
+
+std::vector<BulkRow> make_bulk_rows(int count) {
+    std::vector<BulkRow> rows;
+    rows.reserve(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; i++) {
+        rows.emplace_back(i, "Energy.Active.Import.Register", i * 0.1);
+    }
+    return rows;
+}
+
+/// \brief Loads 10000 rows with bind, step and reset per row inside one transaction, the way callers did before
+/// BatchWriter existed
+void BM_BulkInsertPerRow(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    database->execute_statement("CREATE TABLE bulk (id INTEGER, measurand TEXT, value REAL);");
+    const auto rows = make_bulk_rows(10000);
+    for (auto _ : state) {
+        auto transaction = database->begin_transaction();
+        auto statement = database->new_statement("INSERT INTO bulk VALUES (?, ?, ?);");
+        for (const auto& [id, measurand, value] : rows) {
+            statement->bind_int(1, id);
+            statement->bind_text(2, measurand);
+            statement->bind_double(3, value);
+            statement->step();
+            statement->reset();
+        }
+        transaction->commit();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 10000);
+}
+BENCHMARK(BM_BulkInsertPerRow)->Apply(database_configurations);
+
+void BM_BulkInsertBatchWriter(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    database->execute_statement("CREATE TABLE bulk (id INTEGER, measurand TEXT, value REAL);");
+    const auto rows = make_bulk_rows(10000);
+    BatchOptions options;
+    options.multi_row_values = true;
+    BatchWriter<int, std::string, double> writer{&database.connection(), "INSERT INTO bulk VALUES (?, ?, ?);",
+                                                 options};
+    for (auto _ : state) {
+        writer.write(rows);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 10000);
+}
+BENCHMARK(BM_BulkInsertBatchWriter)->Apply(database_configurations);
+
+/// \brief Applies 21 migrations creating a table and an index each to a new database
+void BM_ApplyMigrationFiles(benchmark::State& state) {
+    const auto migrations = std::filesystem::temp_directory_path() / "everest_sqlite_benchmark_migrations";
+    std::filesystem::remove_all(migrations);
+    std::filesystem::create_directories(migrations);
+    for (int version = 1; version <= 21; version++) {
+        const auto name = std::to_string(version);
+        std::ofstream up{migrations / (name + "_up-table" + name + ".sql")};
+        up << "CREATE TABLE table" << name << " (id INTEGER PRIMARY KEY, key TEXT, value TEXT);\n"
+           << "CREATE INDEX table" << name << "_key ON table" << name << " (key);\n";
+        if (version > 1) {
+            std::ofstream down{migrations / (name + "_down-table" + name + ".sql")};
+            down << "DROP TABLE table" << name << ";\n";
+        }
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto database = std::make_unique<BenchmarkDatabase>(state);
+        state.ResumeTiming();
+
+        SchemaUpdater updater{&database->connection()};
+        if (!updater.apply_migration_files(migrations, 21)) {
+            state.SkipWithError("Migration failed");
+        }
+
+        state.PauseTiming();
+        database.reset();
+        state.ResumeTiming();
+    }
+    std::filesystem::remove_all(migrations);
+}
+BENCHMARK(BM_ApplyMigrationFiles)->Apply(database_configurations);
+
+} // namespace
+
+} // namespace everest::db::sqlite::benchmarks
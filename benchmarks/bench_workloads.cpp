@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+// Macro benchmarks modelled after the database access patterns of EVerest modules
+
+#include <random>
+#include <string>
+
+#include "benchmark_database.hpp"
+
+namespace everest::db::sqlite::benchmarks {
+
+namespace {
+
+/// \brief Appends one meter value with 10 sampled values per transaction, like a charging station reporting
+/// periodic meter values of a running transaction
+void BM_MeterValueAppend(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    database->execute_statement("CREATE TABLE meter_values (id INTEGER PRIMARY KEY, transaction_id TEXT, timestamp "
+                                "INTEGER, measurand TEXT, phase TEXT, value REAL);");
+    database->execute_statement("CREATE INDEX meter_values_transaction ON meter_values (transaction_id);");
+
+    const std::string transaction_id = "transaction-0001";
+    const std::string measurand = "Energy.Active.Import.Register";
+    const std::string phases[] = {"L1", "L2", "L3"};
+    std::int64_t timestamp = 1700000000;
+    for (auto _ : state) {
+        auto transaction = database->begin_transaction();
+        auto statement = database->new_statement("INSERT INTO meter_values (transaction_id, timestamp, measurand, "
+                                                 "phase, value) VALUES (?, ?, ?, ?, ?);");
+        for (int sample = 0; sample < 10; sample++) {
+            statement->bind_text(1, transaction_id);
+            statement->bind_int64(2, timestamp);
+            statement->bind_text(3, measurand);
+            statement->bind_text(4, phases[sample % 3]);
+            statement->bind_double(5, static_cast<double>(timestamp % 1000) + sample);
+            statement->step();
+            statement->reset();
+        }
+        transaction->commit();
+        timestamp += 60;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 10);
+}
+BENCHMARK(BM_MeterValueAppend)->Apply(database_configurations);
+
+/// \brief Looks up single variable attributes by component and variable name in a device model of 2000 variables
+void BM_DeviceModelLookup(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    constexpr int components = 100;
+    constexpr int variables = 20;
+    database->execute_statement("CREATE TABLE variable_attributes (id INTEGER PRIMARY KEY, component TEXT NOT NULL, "
+                                "variable TEXT NOT NULL, type INTEGER NOT NULL, value TEXT);");
+    database->execute_statement(
+        "CREATE UNIQUE INDEX variable_attributes_key ON variable_attributes (component, variable, type);");
+    {
+        auto transaction = database->begin_transaction();
+        for (int component = 0; component < components; component++) {
+            for (int variable = 0; variable < variables; variable++) {
+                database->execute("INSERT INTO variable_attributes (component, variable, type, value) VALUES (?, ?, "
+                                  "0, ?);",
+                                  "Component" + std::to_string(component), "Variable" + std::to_string(variable),
+                                  std::to_string(component * variable));
+            }
+        }
+        transaction->commit();
+    }
+
+    std::mt19937 random{42};
+    std::uniform_int_distribution<int> component_distribution{0, components - 1};
+    std::uniform_int_distribution<int> variable_distribution{0, variables - 1};
+    for (auto _ : state) {
+        const auto component = "Component" + std::to_string(component_distribution(random));
+        const auto variable = "Variable" + std::to_string(variable_distribution(random));
+        auto statement = database->new_statement(
+            "SELECT value FROM variable_attributes WHERE component = ? AND variable = ? AND type = 0;");
+        statement->bind_text(1, component);
+        statement->bind_text(2, variable);
+        if (statement->step() != SQLITE_ROW) {
+            state.SkipWithError("Variable not found");
+            break;
+        }
+        benchmark::DoNotOptimize(statement->column_text_view(0));
+    }
+}
+BENCHMARK(BM_DeviceModelLookup)->Apply(database_configurations);
+
+/// \brief Pops the oldest message from a persistent message queue, like the OCPP message queue does while it is
+/// sending queued transaction messages after being offline
+void BM_QueuePop(benchmark::State& state) {
+    BenchmarkDatabase database{state};
+    database->execute_statement("CREATE TABLE message_queue (id INTEGER PRIMARY KEY AUTOINCREMENT, message TEXT);");
+    const std::string message(512, 'x');
+    constexpr int refill = 1000;
+
+    int queued = 0;
+    for (auto _ : state) {
+        if (queued == 0) {
+            state.PauseTiming();
+            auto transaction = database->begin_transaction();
+            for (int i = 0; i < refill; i++) {
+                database->execute("INSERT INTO message_queue (message) VALUES (?);", message);
+            }
+            transaction->commit();
+            queued = refill;
+            state.ResumeTiming();
+        }
+
+        auto transaction = database->begin_transaction();
+        auto select = database->new_statement("SELECT id, message FROM message_queue ORDER BY id LIMIT 1;");
+        if (select->step() != SQLITE_ROW) {
+            state.SkipWithError("Queue is empty");
+            break;
+        }
+        const auto id = select->column_int64(0);
+        benchmark::DoNotOptimize(select->column_text_view(1));
+        select.reset();
+        database->execute("DELETE FROM message_queue WHERE id = ?;", id);
+        transaction->commit();
+        queued--;
+    }
+}
+BENCHMARK(BM_QueuePop)->Apply(database_configurations);
+
+} // namespace
+
+} // namespace everest::db::sqlite::benchmarks
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <everest/database/sqlite/connection.hpp>
+
+namespace everest::db::sqlite::benchmarks {
+
+enum class Storage {
+    File,
+    Memory
+};
+
+/// \brief Journal modes, synchronous levels and storage the parameterized benchmarks run with, passed as the
+/// benchmark arguments 0, 1 and 2
+constexpr JournalMode JOURNAL_MODES[] = {JournalMode::Delete, JournalMode::Wal, JournalMode::Memory};
+constexpr SynchronousMode SYNCHRONOUS_MODES[] = {SynchronousMode::Off, SynchronousMode::Normal, SynchronousMode::Full};
+constexpr Storage STORAGES[] = {Storage::File, Storage::Memory};
+
+inline const char* to_string(JournalMode mode) {
+    switch (mode) {
+    case JournalMode::Delete:
+        return "delete";
+    case JournalMode::Truncate:
+        return "truncate";
+    case JournalMode::Persist:
+        return "persist";
+    case JournalMode::Memory:
+        return "memory";
+    case JournalMode::Wal:
+        return "wal";
+    case JournalMode::Off:
+        return "off";
+    }
+    return "unknown";
+}
+
+inline const char* to_string(SynchronousMode mode) {
+    switch (mode) {
+    case SynchronousMode::Off:
+        return "off";
+    case SynchronousMode::Normal:
+        return "normal";
+    case SynchronousMode::Full:
+        return "full";
+    case SynchronousMode::Extra:
+        return "extra";
+    }
+    return "unknown";
+}
+
+/// \brief Adds all meaningful combinations of JOURNAL_MODES, SYNCHRONOUS_MODES and STORAGES as arguments. In-memory
+/// databases always use the memory journal and never sync, so they are only added once.
+inline void database_configurations(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"journal", "synchronous", "storage"});
+    for (std::size_t journal = 0; journal < std::size(JOURNAL_MODES); journal++) {
+        for (std::size_t synchronous = 0; synchronous < std::size(SYNCHRONOUS_MODES); synchronous++) {
+            for (std::size_t storage = 0; storage < std::size(STORAGES); storage++) {
+                if (STORAGES[storage] == Storage::Memory and
+                    (JOURNAL_MODES[journal] != JournalMode::Memory or synchronous != 0)) {
+                    continue;
+                }
+                benchmark->Args({static_cast<int64_t>(journal), static_cast<int64_t>(synchronous),
+                                 static_cast<int64_t>(storage)});
+            }
+        }
+    }
+}
+
+/// \brief Database opened for one benchmark run and removed afterwards
+class BenchmarkDatabase {
+private:
+    std::filesystem::path directory;
+    std::unique_ptr<Connection> database;
+
+public:
+    /// \brief Opens a database configured by the arguments added by database_configurations()
+    explicit BenchmarkDatabase(benchmark::State& state) :
+        BenchmarkDatabase(JOURNAL_MODES[state.range(0)], SYNCHRONOUS_MODES[state.range(1)], STORAGES[state.range(2)]) {
+        state.SetLabel(std::string{to_string(JOURNAL_MODES[state.range(0)])} + "/" +
+                       to_string(SYNCHRONOUS_MODES[state.range(1)]) + "/" +
+                       (STORAGES[state.range(2)] == Storage::File ? "file" : "memory"));
+    }
+
+    /// \brief Opens an in-memory database with the default options, for benchmarks that don't touch the disk
+    BenchmarkDatabase() : BenchmarkDatabase(JournalMode::Memory, SynchronousMode::Off, Storage::Memory) {
+    }
+
+    BenchmarkDatabase(JournalMode journal_mode, SynchronousMode synchronous, Storage storage) {
+        static std::atomic_uint32_t counter{0};
+        const auto name = "everest_sqlite_benchmark_" + std::to_string(counter++);
+
+        ConnectionOptions options;
+        options.journal_mode = journal_mode;
+        options.synchronous = synchronous;
+        if (storage == Storage::File) {
+            this->directory = std::filesystem::temp_directory_path() / name;
+            std::filesystem::remove_all(this->directory);
+            this->database = std::make_unique<Connection>(this->directory / "benchmark.db", options);
+        } else {
+            this->database = std::make_unique<Connection>("file:" + name + "?mode=memory&cache=private", options);
+        }
+        if (!this->database->open_connection()) {
+            throw std::runtime_error("Could not open benchmark database");
+        }
+    }
+
+    ~BenchmarkDatabase() {
+        this->database->close_connection();
+        this->database.reset();
+        if (!this->directory.empty()) {
+            std::filesystem::remove_all(this->directory);
+        }
+    }
+
+    BenchmarkDatabase(const BenchmarkDatabase&) = delete;
+    BenchmarkDatabase& operator=(const BenchmarkDatabase&) = delete;
+
+    Connection& connection() {
+        return *this->database;
+    }
+
+    Connection* operator->() {
+        return this->database.get();
+    }
+};
+
+} // namespace everest::db::sqlite::benchmarks
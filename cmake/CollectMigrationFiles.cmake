@@ -1,6 +1,119 @@
+# Writes ARG_EMBED_HEADER, a header defining the validated migration files as a constexpr
+# std::array<everest::db::sqlite::EmbeddedMigration, N> named ARG_EMBED_NAME (default: migrations) together with
+# <ARG_EMBED_NAME>_target_version in namespace ARG_EMBED_NAMESPACE (default: global namespace).
+# The header is only rewritten when its content changes and changing a migration file re-runs CMake.
+macro(_embed_migration_files)
+    if(NOT ARG_EMBED_NAME)
+        set(ARG_EMBED_NAME migrations)
+    endif()
+
+    set(EMBED_DELIMITER "migration_sql")
+    set(EMBED_ENTRIES "")
+    set(EMBED_COUNT 0)
+    foreach(MIGRATION_FILE ${MIGRATION_FILE_LIST})
+        string(REGEX MATCH "^([0-9]+)_(up|down)" MIGRATION_FILE_MATCHED ${MIGRATION_FILE})
+        set(EMBED_VERSION ${CMAKE_MATCH_1})
+        if(CMAKE_MATCH_2 STREQUAL "up")
+            set(EMBED_DIRECTION "Up")
+        else()
+            set(EMBED_DIRECTION "Down")
+        endif()
+
+        file(READ "${ARG_LOCATION}${MIGRATION_FILE}" EMBED_SQL)
+        string(FIND "${EMBED_SQL}" ")${EMBED_DELIMITER}\"" EMBED_DELIMITER_POSITION)
+        if(NOT EMBED_DELIMITER_POSITION EQUAL -1)
+            message(FATAL_ERROR "Migration file can't be embedded since it contains )${EMBED_DELIMITER}\": " ${MIGRATION_FILE})
+        endif()
+
+        string(APPEND EMBED_ENTRIES
+            "    everest::db::sqlite::EmbeddedMigration{${EMBED_VERSION}, everest::db::sqlite::MigrationDirection::${EMBED_DIRECTION},\n"
+            "                                           \"${MIGRATION_FILE}\",\n"
+            "                                           R\"${EMBED_DELIMITER}(${EMBED_SQL})${EMBED_DELIMITER}\"},\n")
+        math(EXPR EMBED_COUNT "${EMBED_COUNT}+1")
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${ARG_LOCATION}${MIGRATION_FILE}")
+    endforeach()
+    # Adding or removing a migration file also has to re-run CMake
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${ARG_LOCATION}")
+
+    set(EMBED_CONTENT "// Generated by collect_migration_files() from ${ARG_LOCATION}, do not edit\n\n")
+    string(APPEND EMBED_CONTENT
+        "#pragma once\n\n"
+        "#include <array>\n\n"
+        "#include <everest/database/sqlite/schema_updater.hpp>\n\n")
+    if(ARG_EMBED_NAMESPACE)
+        string(APPEND EMBED_CONTENT "namespace ${ARG_EMBED_NAMESPACE} {\n\n")
+    endif()
+    string(APPEND EMBED_CONTENT
+        "inline constexpr std::uint32_t ${ARG_EMBED_NAME}_target_version = ${CURRENT_MIGRATION_FILE_ID};\n\n"
+        "inline constexpr std::array<everest::db::sqlite::EmbeddedMigration, ${EMBED_COUNT}> ${ARG_EMBED_NAME}{\n"
+        "${EMBED_ENTRIES}"
+        "};\n")
+    if(ARG_EMBED_NAMESPACE)
+        string(APPEND EMBED_CONTENT "\n} // namespace ${ARG_EMBED_NAMESPACE}\n")
+    endif()
+
+    file(WRITE "${ARG_EMBED_HEADER}.tmp" "${EMBED_CONTENT}")
+    configure_file("${ARG_EMBED_HEADER}.tmp" "${ARG_EMBED_HEADER}" COPYONLY)
+    file(REMOVE "${ARG_EMBED_HEADER}.tmp")
+endmacro()
+
+# Adds a build step creating ARG_INITIAL_DATABASE_IMAGE, a VACUUMed database with all up migrations applied and
+# user_version set to the latest version, using the sqlite3 command line shell. The step is driven by the target
+# ARG_INITIAL_DATABASE_IMAGE_TARGET (default: <image name>_initial_database_image), which is built by default.
+# SchemaUpdater::use_initial_database_image() copies this image into new databases instead of applying each migration.
+macro(_build_initial_database_image)
+    find_program(SQLITE3_EXECUTABLE sqlite3)
+    if(NOT SQLITE3_EXECUTABLE)
+        message(FATAL_ERROR "The sqlite3 command line shell is required to build INITIAL_DATABASE_IMAGE")
+    endif()
+
+    if(NOT ARG_INITIAL_DATABASE_IMAGE_TARGET)
+        get_filename_component(IMAGE_NAME ${ARG_INITIAL_DATABASE_IMAGE} NAME_WE)
+        set(ARG_INITIAL_DATABASE_IMAGE_TARGET ${IMAGE_NAME}_initial_database_image)
+    endif()
+
+    # Up migrations have to be applied by version, which is not the alphabetical order of the files
+    set(IMAGE_SCRIPT "BEGIN;\n")
+    set(IMAGE_DEPENDS "")
+    foreach(IMAGE_VERSION RANGE 1 ${CURRENT_MIGRATION_FILE_ID})
+        foreach(MIGRATION_FILE ${MIGRATION_FILE_LIST})
+            if(MIGRATION_FILE MATCHES "^${IMAGE_VERSION}_up")
+                string(APPEND IMAGE_SCRIPT ".read \"${ARG_LOCATION}${MIGRATION_FILE}\"\n")
+                list(APPEND IMAGE_DEPENDS "${ARG_LOCATION}${MIGRATION_FILE}")
+            endif()
+        endforeach()
+    endforeach()
+    string(APPEND IMAGE_SCRIPT "PRAGMA user_version = ${CURRENT_MIGRATION_FILE_ID};\nCOMMIT;\nVACUUM;\n")
+
+    set(IMAGE_SCRIPT_FILE "${CMAKE_CURRENT_BINARY_DIR}/${ARG_INITIAL_DATABASE_IMAGE_TARGET}.sql")
+    file(WRITE "${IMAGE_SCRIPT_FILE}.tmp" "${IMAGE_SCRIPT}")
+    configure_file("${IMAGE_SCRIPT_FILE}.tmp" "${IMAGE_SCRIPT_FILE}" COPYONLY)
+    file(REMOVE "${IMAGE_SCRIPT_FILE}.tmp")
+
+    add_custom_command(
+        OUTPUT ${ARG_INITIAL_DATABASE_IMAGE}
+        COMMAND ${CMAKE_COMMAND} -E remove -f ${ARG_INITIAL_DATABASE_IMAGE}.tmp
+        COMMAND ${SQLITE3_EXECUTABLE} -batch -bail ${ARG_INITIAL_DATABASE_IMAGE}.tmp ".read '${IMAGE_SCRIPT_FILE}'"
+        COMMAND ${CMAKE_COMMAND} -E rename ${ARG_INITIAL_DATABASE_IMAGE}.tmp ${ARG_INITIAL_DATABASE_IMAGE}
+        DEPENDS ${IMAGE_DEPENDS} ${IMAGE_SCRIPT_FILE}
+        COMMENT "Building initial database image ${ARG_INITIAL_DATABASE_IMAGE}"
+        VERBATIM
+    )
+    add_custom_target(${ARG_INITIAL_DATABASE_IMAGE_TARGET} ALL DEPENDS ${ARG_INITIAL_DATABASE_IMAGE})
+    set(INITIAL_DATABASE_IMAGE_TARGET ${ARG_INITIAL_DATABASE_IMAGE_TARGET} PARENT_SCOPE)
+endmacro()
+
 function(collect_migration_files)
     set(options "")
-    set(oneValueArgs LOCATION INSTALL_DESTINATION)
+    set(oneValueArgs
+        LOCATION
+        INSTALL_DESTINATION
+        EMBED_HEADER
+        EMBED_NAMESPACE
+        EMBED_NAME
+        INITIAL_DATABASE_IMAGE
+        INITIAL_DATABASE_IMAGE_TARGET
+    )
     set(multiValueArgs "")
     cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
 
@@ -53,9 +166,20 @@ function(collect_migration_files)
     # Since we always add on the up file we need to subtract one here
     math(EXPR CURRENT_MIGRATION_FILE_ID "${CURRENT_MIGRATION_FILE_ID}-1")
 
+    if(ARG_EMBED_HEADER)
+        _embed_migration_files()
+    endif()
+
+    if(ARG_INITIAL_DATABASE_IMAGE)
+        _build_initial_database_image()
+    endif()
+
     list(TRANSFORM MIGRATION_FILE_LIST PREPEND ${ARG_LOCATION})
     if(ARG_INSTALL_DESTINATION)
         install(FILES ${MIGRATION_FILE_LIST} DESTINATION ${ARG_INSTALL_DESTINATION})
+        if(ARG_INITIAL_DATABASE_IMAGE)
+            install(FILES ${ARG_INITIAL_DATABASE_IMAGE} DESTINATION ${ARG_INSTALL_DESTINATION})
+        endif()
     endif()
 
     set(TARGET_MIGRATION_FILE_VERSION ${CURRENT_MIGRATION_FILE_ID} PARENT_SCOPE)
@@ -44,6 +44,13 @@ public:
     }
 };
 
+/// \brief Exception for errors while creating a backup of a database
+class BackupException : public Exception {
+public:
+    explicit BackupException(const std::string& message) : Exception(message) {
+    }
+};
+
 /// \brief Exception for errors during query execution
 class QueryExecutionException : public Exception {
 public:
@@ -51,4 +58,12 @@ public:
     }
 };
 
+/// \brief Exception for queries that were interrupted because their deadline passed, they were cancelled or the
+/// connection was interrupted
+class QueryInterruptedException : public QueryExecutionException {
+public:
+    explicit QueryInterruptedException(const std::string& message) : QueryExecutionException(message) {
+    }
+};
+
 } // namespace everest::db
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <everest/database/sqlite/connection_pool.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Queue counters of one executor of an AsyncConnection
+struct AsyncConnectionStats {
+    std::size_t queue_depth{0};                   ///< Tasks currently waiting to be started
+    std::size_t max_queue_depth{0};               ///< Highest number of tasks waiting at the same time
+    std::uint64_t tasks_completed{0};             ///< Tasks that finished, successfully or with an exception
+    std::chrono::microseconds total_wait_time{0}; ///< Sum of the times tasks waited in the queue before they started
+    std::chrono::microseconds max_wait_time{0};   ///< Longest time a task waited in the queue
+};
+
+/// \brief Runs database work on dedicated threads, so callers like MQTT callbacks or websocket handlers never block on
+/// SQLite or on fsync.
+///
+/// All work given to submit(), transaction(), execute() and query() runs on one writer thread, strictly in the order
+/// it was submitted. Work given to read() runs on a reader connection of a ConnectionPool, on up to
+/// \p reader_threads threads. Reads start in the order they were submitted but can run concurrently.
+/// Results and exceptions are delivered through std::future.
+/// \note Work must not wait for the future of other work of the same AsyncConnection, that can deadlock the queue
+class AsyncConnection {
+private:
+    /// \brief Threads running queued tasks in FIFO order
+    class Executor {
+    private:
+        struct Task {
+            std::function<void()> run;
+            std::chrono::steady_clock::time_point submitted;
+        };
+
+        mutable std::mutex queue_mutex;
+        std::condition_variable queue_changed;
+        std::deque<Task> queue;
+        bool running;
+        AsyncConnectionStats stats;
+        std::vector<std::thread> threads;
+
+        void run();
+
+    public:
+        explicit Executor(std::size_t thread_count);
+
+        /// \brief Runs all queued tasks, then stops the threads
+        ~Executor();
+
+        void push(std::function<void()> task);
+        AsyncConnectionStats get_stats() const;
+    };
+
+    /// \brief Queues \p work on \p executor and returns the future of its result
+    template <typename Work> static auto enqueue(Executor& executor, Work work);
+
+    /// \brief Returns work running \p sql with \p args on a ConnectionInterface or ReaderLease, see query()
+    template <typename... Columns, typename... Args> static auto query_work(std::string sql, Args... args);
+
+    ConnectionInterface* database;
+    ConnectionPool* pool;
+    std::unique_ptr<Executor> readers; ///< Only set if there are reader threads
+    Executor writer;
+
+public:
+    /// \brief Starts the writer thread executing work on \p database
+    /// \note \p database must be open and outlive this object
+    explicit AsyncConnection(ConnectionInterface* database);
+
+    /// \brief Starts the writer thread executing work on \p pool and \p reader_threads threads executing reads on the
+    /// reader connections of \p pool
+    /// \note \p pool must be open and outlive this object
+    AsyncConnection(ConnectionPool* pool, std::size_t reader_threads);
+
+    /// \brief Runs all queued work, then stops the threads
+    ~AsyncConnection() = default;
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    /// \brief Queues \p work, which is called with the connection on the writer thread
+    /// \return Future holding the result of \p work or the exception it threw
+    template <typename Work> auto submit(Work work) -> std::future<std::invoke_result_t<Work&, ConnectionInterface&>>;
+
+    /// \brief Like submit(), but \p work runs inside a transaction that is committed when \p work returns and rolled
+    /// back when it throws
+    template <typename Work>
+    auto transaction(Work work) -> std::future<std::invoke_result_t<Work&, ConnectionInterface&>>;
+
+    /// \brief Queues ConnectionInterface::execute() of \p sql with \p args. The arguments are copied.
+    template <typename... Args> std::future<ExecuteResult> execute(std::string sql, Args... args);
+
+    /// \brief Queues the query \p sql with \p args bound to its parameters and returns all result rows decoded into
+    /// tuples of \p Columns, see RowRange. The arguments are copied. Runs on the writer thread in submission order, so
+    /// it sees all work queued before it.
+    /// \note Only owning column types can be used, std::string_view and ByteSpan would dangle
+    template <typename... Columns, typename... Args>
+    std::future<std::vector<std::tuple<Columns...>>> query(std::string sql, Args... args);
+
+    /// \brief Like query(), but runs on one of the reader threads. It neither waits for nor blocks the writer, but may
+    /// run before work queued earlier on the writer thread is finished and doesn't see its changes then.
+    /// \note Will throw a ConnectionException if the AsyncConnection has no reader threads
+    template <typename... Columns, typename... Args>
+    std::future<std::vector<std::tuple<Columns...>>> query_reader(std::string sql, Args... args);
+
+    /// \brief Queues \p work, which is called with a leased reader connection on one of the reader threads
+    /// \note Will throw a ConnectionException if the AsyncConnection has no reader threads
+    template <typename Work> auto read(Work work) -> std::future<std::invoke_result_t<Work&, ReaderLease&>>;
+
+    /// \brief Returns the queue counters of the writer thread
+    AsyncConnectionStats get_stats() const;
+
+    /// \brief Returns the queue counters of the reader threads, all zero if there are none
+    AsyncConnectionStats get_reader_stats() const;
+};
+
+template <typename Work> auto AsyncConnection::enqueue(Executor& executor, Work work) {
+    using Result = std::invoke_result_t<Work&>;
+    // std::function needs a copyable callable, the packaged task is shared
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::move(work));
+    auto future = task->get_future();
+    executor.push([task]() { (*task)(); });
+    return future;
+}
+
+template <typename Work>
+auto AsyncConnection::submit(Work work) -> std::future<std::invoke_result_t<Work&, ConnectionInterface&>> {
+    return enqueue(this->writer, [database = this->database, work = std::move(work)]() mutable {
+        return work(*database);
+    });
+}
+
+template <typename Work>
+auto AsyncConnection::transaction(Work work) -> std::future<std::invoke_result_t<Work&, ConnectionInterface&>> {
+    return enqueue(this->writer, [database = this->database, work = std::move(work)]() mutable {
+        auto transaction = database->begin_transaction();
+        if constexpr (std::is_void_v<std::invoke_result_t<Work&, ConnectionInterface&>>) {
+            work(*database);
+            transaction->commit();
+        } else {
+            auto result = work(*database);
+            transaction->commit();
+            return result;
+        }
+    });
+}
+
+template <typename... Args> std::future<ExecuteResult> AsyncConnection::execute(std::string sql, Args... args) {
+    return this->submit([sql = std::move(sql), args = std::make_tuple(std::move(args)...)](ConnectionInterface& db) {
+        return std::apply([&db, &sql](const auto&... values) { return db.execute(sql, values...); }, args);
+    });
+}
+
+template <typename... Columns, typename... Args> auto AsyncConnection::query_work(std::string sql, Args... args) {
+    static_assert(((!std::is_same_v<Columns, std::string_view> and !std::is_same_v<Columns, ByteSpan>) and ...),
+                  "Query results must own their values");
+    return [sql = std::move(sql), args = std::make_tuple(std::move(args)...)](auto& db) {
+        auto statement = db.new_statement(sql);
+        if (bind_values(*statement, 1, args) != SQLITE_OK) {
+            throw QueryExecutionException(std::string{"Could not bind parameters: "} + db.get_error_message());
+        }
+        std::vector<std::tuple<Columns...>> rows;
+        auto range = statement->template rows<Columns...>();
+        for (auto&& row : range) {
+            rows.push_back(std::move(row));
+        }
+        return rows;
+    };
+}
+
+template <typename... Columns, typename... Args>
+std::future<std::vector<std::tuple<Columns...>>> AsyncConnection::query(std::string sql, Args... args) {
+    return this->submit(query_work<Columns...>(std::move(sql), std::move(args)...));
+}
+
+template <typename... Columns, typename... Args>
+std::future<std::vector<std::tuple<Columns...>>> AsyncConnection::query_reader(std::string sql, Args... args) {
+    return this->read(query_work<Columns...>(std::move(sql), std::move(args)...));
+}
+
+template <typename Work>
+auto AsyncConnection::read(Work work) -> std::future<std::invoke_result_t<Work&, ReaderLease&>> {
+    if (this->readers == nullptr) {
+        throw ConnectionException("AsyncConnection has no reader threads");
+    }
+    return enqueue(*this->readers, [pool = this->pool, work = std::move(work)]() mutable {
+        auto lease = pool->acquire_reader();
+        return work(lease);
+    });
+}
+
+} // namespace everest::db::sqlite
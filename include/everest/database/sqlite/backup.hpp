@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include <everest/database/sqlite/cancellation_token.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Progress of an online backup, reported after every step
+struct BackupProgress {
+    int total_pages{0};     ///< Number of pages of the source database
+    int remaining_pages{0}; ///< Number of pages that still have to be copied
+};
+
+/// \brief Pacing, progress reporting and cancellation of ConnectionInterface::backup_to()
+struct BackupOptions {
+    /// Number of pages copied per step while the source database is locked, values <= 0 copy everything in one step
+    int pages_per_step{64};
+    /// Pause after every step (and after the source was busy) that lets other writers access the database
+    std::chrono::milliseconds pause_between_steps{10};
+    /// Called from the backup thread after every step
+    std::function<void(const BackupProgress&)> on_progress;
+    /// Stops the backup before the next step, the destination is left unchanged
+    CancellationToken cancellation;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/binding.hpp>
+#include <everest/database/sqlite/connection.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Variable limit used if the connection can't report SQLITE_LIMIT_VARIABLE_NUMBER, the lowest default of all
+/// SQLite versions
+constexpr int BATCH_FALLBACK_MAX_VARIABLES = 999;
+
+/// \brief Options of a BatchWriter
+struct BatchOptions {
+    /// Expands the single row VALUES clause of the SQL template into chunks of multiple rows, so one step() inserts
+    /// many rows. Requires anonymous "?" placeholders.
+    bool multi_row_values{false};
+    /// Maximum number of bound variables per statement. Defaults to and is clamped to SQLITE_LIMIT_VARIABLE_NUMBER of
+    /// the connection, see ConnectionInterface::get_limit.
+    std::optional<int> max_variables;
+};
+
+/// \brief Result of a BatchWriter::write call
+struct BatchResult {
+    std::size_t rows{0};                 ///< Number of rows written
+    std::chrono::nanoseconds elapsed{0}; ///< Time spent including the commit
+
+    /// \brief Returns the write throughput in rows per second
+    double rows_per_second() const;
+};
+
+namespace detail {
+/// \brief Repeats the parenthesized group after VALUES in \p sql \p rows times
+/// \note Will throw a QueryExecutionException if \p sql has no VALUES group with exactly \p columns "?" placeholders
+std::string expand_values_clause(const std::string& sql, std::size_t columns, std::size_t rows);
+} // namespace detail
+
+/// \brief Writes many rows with a single prepared INSERT (or UPDATE, DELETE) statement inside one transaction.
+///
+/// The SQL template binds one row of Columns... to its parameters 1..N, e.g. "INSERT INTO t (a, b) VALUES (?, ?)". Rows
+/// are std::tuple<Columns...>, all types supported by bind_value can be used. With BatchOptions::multi_row_values the
+/// VALUES clause is expanded to as many rows as fit into BatchOptions::max_variables, the remaining rows are written
+/// with the single row statement.
+template <typename... Columns> class BatchWriter {
+public:
+    using Row = std::tuple<Columns...>;
+
+private:
+    ConnectionInterface* database;
+    const std::string sql;
+    const BatchOptions options;
+    std::string chunk_sql;
+    std::size_t rows_per_chunk;
+
+    void bind_row(StatementInterface& statement, int first_idx, const Row& row) {
+        if (bind_values(statement, first_idx, row) != SQLITE_OK) {
+            throw QueryExecutionException(std::string{"Could not bind batch row: "} +
+                                          this->database->get_error_message());
+        }
+    }
+
+    void step_row(StatementInterface& statement) {
+        if (statement.step() != SQLITE_DONE) {
+            throw QueryExecutionException(std::string{"Batch write failed: "} + this->database->get_error_message());
+        }
+        statement.reset();
+    }
+
+public:
+    /// \brief Creates a writer executing \p sql on \p database
+    /// \note Will throw a QueryExecutionException if multi-row VALUES are requested but \p sql can't be expanded
+    BatchWriter(ConnectionInterface* database, std::string sql, const BatchOptions& options = {}) :
+        database(database), sql(std::move(sql)), options(options), rows_per_chunk(1) {
+        constexpr auto columns = sizeof...(Columns);
+        if (this->options.multi_row_values and columns > 0) {
+            auto limit = this->database->get_limit(SQLITE_LIMIT_VARIABLE_NUMBER);
+            if (limit <= 0) {
+                limit = BATCH_FALLBACK_MAX_VARIABLES;
+            }
+            const auto max_variables = std::clamp(this->options.max_variables.value_or(limit), 1, limit);
+            this->rows_per_chunk = std::max<std::size_t>(1, static_cast<std::size_t>(max_variables) / columns);
+            this->chunk_sql = detail::expand_values_clause(this->sql, columns, this->rows_per_chunk);
+        }
+    }
+
+    /// \brief Writes all rows of \p rows in one transaction, which is rolled back if a row fails
+    /// \note Will throw a QueryExecutionException if a row can't be written
+    template <typename Rows> BatchResult write(const Rows& rows) {
+        return this->write(std::begin(rows), std::end(rows));
+    }
+
+    /// \brief Writes the rows in [first, last) in one transaction, which is rolled back if a row fails. Input iterators
+    /// are supported, their rows are copied while a chunk is collected.
+    /// \note Will throw a QueryExecutionException if a row can't be written
+    template <typename InputIt> BatchResult write(InputIt first, InputIt last) {
+        constexpr bool forward = std::is_base_of_v<std::forward_iterator_tag,
+                                                   typename std::iterator_traits<InputIt>::iterator_category>;
+        using Buffered = std::conditional_t<forward, const Row*, Row>;
+
+        const auto start = std::chrono::steady_clock::now();
+        BatchResult result;
+        auto transaction = this->database->begin_transaction();
+        auto statement = this->database->new_statement(this->sql);
+
+        if (this->rows_per_chunk <= 1) {
+            for (; first != last; ++first) {
+                const Row& row = *first;
+                this->bind_row(*statement, 1, row);
+                this->step_row(*statement);
+                result.rows++;
+            }
+        } else {
+            std::unique_ptr<StatementInterface> chunk_statement;
+            std::vector<Buffered> chunk;
+            chunk.reserve(this->rows_per_chunk);
+            for (; first != last; ++first) {
+                if constexpr (forward) {
+                    chunk.push_back(&*first);
+                } else {
+                    chunk.push_back(*first);
+                }
+                if (chunk.size() < this->rows_per_chunk) {
+                    continue;
+                }
+                if (chunk_statement == nullptr) {
+                    chunk_statement = this->database->new_statement(this->chunk_sql);
+                }
+                int idx = 1;
+                for (const auto& row : chunk) {
+                    if constexpr (forward) {
+                        this->bind_row(*chunk_statement, idx, *row);
+                    } else {
+                        this->bind_row(*chunk_statement, idx, row);
+                    }
+                    idx += static_cast<int>(sizeof...(Columns));
+                }
+                this->step_row(*chunk_statement);
+                result.rows += chunk.size();
+                chunk.clear();
+            }
+            // Rows that don't fill a chunk use the single row statement instead of preparing another statement
+            for (const auto& row : chunk) {
+                if constexpr (forward) {
+                    this->bind_row(*statement, 1, *row);
+                } else {
+                    this->bind_row(*statement, 1, row);
+                }
+                this->step_row(*statement);
+                result.rows++;
+            }
+        }
+
+        transaction->commit();
+        result.elapsed = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+};
+
+} // namespace everest::db::sqlite
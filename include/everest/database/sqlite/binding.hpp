@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <everest/database/sqlite/statement.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Binds \p val to parameter \p idx using the bind_* call matching its type.
+///
+/// Supported types are integral types (bound as int or int64), floating point types, std::string, const char*,
+/// ByteSpan, std::vector<uint8_t>, std::nullptr_t / std::nullopt_t (bound as NULL) and std::optional of these.
+/// \note Text and BLOB values are bound as SQLiteString::Static except for const char*, they must stay valid until the
+/// statement was stepped
+template <typename T> int bind_value(StatementInterface& statement, int idx, const T& val) {
+    if constexpr (detail::is_optional<T>::value) {
+        if (!val.has_value()) {
+            return statement.bind_null(idx);
+        }
+        return bind_value(statement, idx, *val);
+    } else if constexpr (std::is_same_v<T, std::nullptr_t> or std::is_same_v<T, std::nullopt_t>) {
+        return statement.bind_null(idx);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return statement.bind_int(idx, val ? 1 : 0);
+    } else if constexpr (std::is_integral_v<T> and sizeof(T) <= sizeof(int) and
+                         (std::is_signed_v<T> or sizeof(T) < sizeof(int))) {
+        return statement.bind_int(idx, static_cast<int>(val));
+    } else if constexpr (std::is_integral_v<T>) {
+        return statement.bind_int64(idx, static_cast<int64_t>(val));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return statement.bind_double(idx, static_cast<double>(val));
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return statement.bind_text(idx, val, SQLiteString::Static);
+    } else if constexpr (std::is_same_v<std::decay_t<T>, const char*> or std::is_same_v<std::decay_t<T>, char*>) {
+        return statement.bind_text(idx, std::string{val}, SQLiteString::Transient);
+    } else if constexpr (std::is_same_v<T, ByteSpan> or std::is_same_v<T, std::vector<std::uint8_t>>) {
+        return statement.bind_blob(idx, val, SQLiteString::Static);
+    } else {
+        static_assert(detail::always_false<T>, "Unsupported parameter type");
+    }
+}
+
+namespace detail {
+template <typename Tuple, std::size_t... Idx>
+int bind_tuple(StatementInterface& statement, int first_idx, const Tuple& values, std::index_sequence<Idx...>) {
+    int result = SQLITE_OK;
+    ((result = result == SQLITE_OK ? bind_value(statement, first_idx + static_cast<int>(Idx), std::get<Idx>(values))
+                                   : result),
+     ...);
+    return result;
+}
+} // namespace detail
+
+/// \brief Binds the elements of \p values to consecutive parameters starting at \p first_idx
+/// \return SQLITE_OK or the result of the first bind that failed
+template <typename... Ts>
+int bind_values(StatementInterface& statement, int first_idx, const std::tuple<Ts...>& values) {
+    return detail::bind_tuple(statement, first_idx, values, std::index_sequence_for<Ts...>{});
+}
+
+} // namespace everest::db::sqlite
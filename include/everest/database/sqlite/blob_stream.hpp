@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include <everest/database/sqlite/statement.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Interface for incremental access to a single BLOB value, so large values can be read and written in chunks
+/// without loading them completely into memory
+class BlobStreamInterface {
+public:
+    virtual ~BlobStreamInterface() = default;
+
+    /// \brief Returns the size of the BLOB in bytes
+    virtual std::size_t size() = 0;
+
+    /// \brief Reads \p length bytes starting at \p offset into \p buffer
+    /// \note Will throw a QueryExecutionException if the range is outside of the BLOB or the row changed
+    virtual void read(std::size_t offset, std::uint8_t* buffer, std::size_t length) = 0;
+
+    /// \brief Reads \p length bytes starting at \p offset
+    /// \note Will throw a QueryExecutionException if the range is outside of the BLOB or the row changed
+    virtual std::vector<std::uint8_t> read(std::size_t offset, std::size_t length) = 0;
+
+    /// \brief Writes \p data starting at \p offset. The size of a BLOB can't be changed by writing, reserve space with
+    /// StatementInterface::bind_zeroblob first.
+    /// \note Will throw a QueryExecutionException if the range is outside of the BLOB or the stream is read-only
+    virtual void write(std::size_t offset, ByteSpan data) = 0;
+
+    /// \brief Moves the stream to the same column of the row with \p rowid, which is faster than opening a new one
+    /// \note Will throw a QueryExecutionException if the row does not exist
+    virtual void reopen(std::int64_t rowid) = 0;
+};
+
+/// \brief RAII wrapper around sqlite3_blob
+class BlobStream : public BlobStreamInterface {
+private:
+    sqlite3_blob* blob;
+    sqlite3* db;
+
+public:
+    /// \brief Opens the BLOB in \p column of the row with \p rowid in \p table
+    /// \note Will throw a QueryExecutionException if the BLOB can't be opened
+    BlobStream(sqlite3* db, const std::string& table, const std::string& column, std::int64_t rowid, bool writable);
+    ~BlobStream() override;
+
+    BlobStream(const BlobStream&) = delete;
+    BlobStream& operator=(const BlobStream&) = delete;
+
+    std::size_t size() override;
+    void read(std::size_t offset, std::uint8_t* buffer, std::size_t length) override;
+    std::vector<std::uint8_t> read(std::size_t offset, std::size_t length) override;
+    void write(std::size_t offset, ByteSpan data) override;
+    void reopen(std::int64_t rowid) override;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+#include <sqlite3.h>
+
+#include <everest/database/sqlite/connection_options.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Counters of the locks a connection had to wait for, see BusyHandler
+struct BusyStats {
+    std::uint64_t busy_events{0};                 ///< Locks that were held by another connection on the first attempt
+    std::uint64_t retries{0};                     ///< Retries after a backoff delay
+    std::uint64_t timeouts{0};                    ///< Busy events that gave up after BusyRetryOptions::timeout
+    std::chrono::microseconds total_wait_time{0}; ///< Sum of all backoff delays
+    std::chrono::microseconds max_wait_time{0};   ///< Longest wait of a single busy event up to its last retry
+};
+
+/// \brief Busy handler retrying with jittered exponential backoff. When a lock is held by another connection, SQLite
+/// calls the handler, which sleeps and lets SQLite retry until BusyRetryOptions::timeout is spent.
+class BusyHandler {
+private:
+    const BusyRetryOptions options;
+    mutable std::mutex stats_mutex;
+    std::minstd_rand random;
+    std::chrono::steady_clock::time_point event_start; ///< Start of the current busy event
+    BusyStats stats;
+
+    static int callback(void* context, int count);
+    bool retry(int count);
+
+public:
+    explicit BusyHandler(const BusyRetryOptions& options);
+
+    /// \brief Installs the handler on \p db, replacing any busy timeout
+    void attach(sqlite3* db);
+
+    BusyStats get_stats() const;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace everest::db::sqlite {
+
+/// \brief Requests a long running operation to stop from any thread. Copies share the same state, so a copy can be
+/// handed to the operation while the original is kept to cancel it.
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic_bool> cancelled;
+
+public:
+    CancellationToken() : cancelled(std::make_shared<std::atomic_bool>(false)) {
+    }
+
+    /// \brief Requests the operation to stop at the next opportunity
+    void cancel() {
+        this->cancelled->store(true);
+    }
+
+    bool is_cancelled() const {
+        return this->cancelled->load();
+    }
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <sqlite3.h>
+
+#include <everest/database/sqlite/connection_options.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Counters describing the checkpoints run by a CheckpointScheduler
+struct CheckpointStats {
+    std::uint64_t passive_checkpoints{0};        ///< Checkpoints run because the connection was idle
+    std::uint64_t escalated_checkpoints{0};      ///< Checkpoints run because the WAL reached its size limit
+    std::uint64_t busy_checkpoints{0};           ///< Checkpoints that timed out waiting for readers or writers
+    std::chrono::microseconds last_duration{0};  ///< Duration of the latest checkpoint
+    std::chrono::microseconds max_duration{0};   ///< Duration of the longest checkpoint
+    std::chrono::microseconds total_duration{0}; ///< Sum of the durations of all checkpoints
+    int wal_frames{0};                           ///< Frames in the WAL file, as reported by the latest commit
+    int frames_pending{0};                       ///< Frames in the WAL not copied to the database file yet
+};
+
+/// \brief Runs the WAL checkpoints of a connection on a background thread instead of inside the commit that crosses
+/// the automatic checkpoint threshold.
+///
+/// A WAL hook on the attached connection replaces the automatic checkpoint and tracks the WAL size and the time of the
+/// last commit. Once no commit happened for CheckpointOptions::idle_time, a passive checkpoint copies the pending
+/// frames without blocking anyone. If the WAL reaches CheckpointOptions::wal_size_limit, e.g. because the connection
+/// is never idle or readers keep passive checkpoints from completing, CheckpointOptions::escalation_mode is used
+/// instead. Checkpoints run on a separate connection, so they never hold the mutex of the attached connection.
+class CheckpointScheduler {
+private:
+    const CheckpointOptions options;
+    sqlite3* database;   ///< Attached connection
+    sqlite3* checkpoint; ///< Connection used by the background thread
+    std::uint64_t frame_size;
+
+    mutable std::mutex state_mutex;
+    std::condition_variable state_changed;
+    bool running;
+    std::chrono::steady_clock::time_point last_commit;
+    std::chrono::steady_clock::time_point retry_at; ///< No checkpoint is started before, set after each attempt
+    int checkpointed_frames;
+    CheckpointStats stats;
+    std::thread worker;
+
+    static int wal_hook(void* context, sqlite3* db, const char* schema, int frames);
+    void on_commit(int frames);
+    void run();
+    void run_checkpoint(CheckpointMode mode);
+
+public:
+    explicit CheckpointScheduler(const CheckpointOptions& options);
+
+    /// \brief Stops the background thread, see detach()
+    ~CheckpointScheduler();
+
+    CheckpointScheduler(const CheckpointScheduler&) = delete;
+    CheckpointScheduler& operator=(const CheckpointScheduler&) = delete;
+
+    /// \brief Disables the automatic checkpoint of \p db and starts the background thread checkpointing its WAL
+    /// \return False if \p db is not a database file in WAL mode or the checkpoint connection can't be opened. The
+    /// reason is logged.
+    bool attach(sqlite3* db);
+
+    /// \brief Stops the background thread and removes the WAL hook. Must be called before the attached connection is
+    /// closed. Pending frames are left to SQLite, which checkpoints them when the last connection is closed.
+    void detach();
+
+    /// \brief Returns a snapshot of the checkpoint counters
+    CheckpointStats get_stats() const;
+};
+
+} // namespace everest::db::sqlite
@@ -4,12 +4,29 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sqlite3.h>
+#include <thread>
+#include <vector>
 
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/backup.hpp>
+#include <everest/database/sqlite/binding.hpp>
+#include <everest/database/sqlite/blob_stream.hpp>
+#include <everest/database/sqlite/busy_handler.hpp>
+#include <everest/database/sqlite/checkpoint_scheduler.hpp>
+#include <everest/database/sqlite/connection_options.hpp>
+#include <everest/database/sqlite/priority_timed_mutex.hpp>
+#include <everest/database/sqlite/query_guard.hpp>
+#include <everest/database/sqlite/query_profiler.hpp>
 #include <everest/database/sqlite/statement.hpp>
+#include <everest/database/sqlite/statement_cache.hpp>
 
 namespace fs = std::filesystem;
 
@@ -29,6 +46,65 @@ public:
     virtual void rollback() = 0;
 };
 
+/// \brief Memory and page cache counters of a connection from sqlite3_db_status
+struct ConnectionStats {
+    std::int64_t cache_hits{0};            ///< Page cache hits
+    std::int64_t cache_misses{0};          ///< Page cache misses, i.e. pages read from the file system
+    std::int64_t cache_writes{0};          ///< Dirty pages written to the file system
+    std::int64_t cache_spills{0};          ///< Dirty pages written before the commit because the cache was full
+    std::int64_t cache_used{0};            ///< Heap bytes used by the page cache
+    std::int64_t cache_used_shared{0};     ///< Like cache_used, shared caches split between their connections
+    std::int64_t lookaside_used{0};        ///< Lookaside memory slots currently in use
+    std::int64_t lookaside_highwater{0};   ///< Highest number of lookaside slots used at the same time
+    std::int64_t lookaside_hits{0};        ///< Allocations served from lookaside memory
+    std::int64_t lookaside_miss_size{0};   ///< Allocations too large for lookaside memory
+    std::int64_t lookaside_miss_full{0};   ///< Allocations that missed because all lookaside memory was in use
+    std::int64_t schema_used{0};           ///< Heap bytes used to store the schema
+    std::int64_t statements_used{0};       ///< Heap bytes used by all prepared statements
+    std::int64_t deferred_foreign_keys{0}; ///< 1 if there are unresolved deferred foreign key constraints, else 0
+};
+
+/// \brief Result of ConnectionInterface::execute
+struct ExecuteResult {
+    int changes{0};                 ///< Number of rows changed by the statement
+    int64_t last_inserted_rowid{0}; ///< Rowid of the most recent successful INSERT on the connection
+};
+
+/// \brief When a transaction acquires its database locks, see SQLite's BEGIN documentation
+enum class TransactionMode {
+    Deferred,  ///< Locks are acquired by the first read and write, the write can fail with SQLITE_BUSY on upgrade
+    Immediate, ///< The write lock is acquired at the start, so other writers wait before the transaction does work
+    Exclusive, ///< Like Immediate, outside of WAL mode readers are locked out as well
+};
+
+/// \brief Options of ConnectionInterface::begin_transaction
+struct TransactionOptions {
+    /// Waiting transactions with a higher priority start first when the previous transaction is finished
+    TransactionPriority priority{TransactionPriority::Normal};
+    /// Maximum time to wait for the previous transaction to finish, waits indefinitely if not set
+    std::optional<std::chrono::milliseconds> timeout;
+    /// Ignored for nested transactions, they are savepoints of the enclosing transaction
+    TransactionMode mode{TransactionMode::Deferred};
+};
+
+/// \brief Options of ConnectionInterface::truncate_tables
+struct TruncateOptions {
+    /// Number of free pages returned to the file system with PRAGMA incremental_vacuum after the tables are cleared.
+    /// 0 keeps the free pages for reuse, a negative value returns all of them. Requires ConnectionOptions::auto_vacuum
+    /// Incremental.
+    int vacuum_pages{0};
+};
+
+/// \brief Result of ConnectionInterface::truncate_tables
+struct TruncateResult {
+    std::int64_t rows_deleted{0};
+    /// Tables SQLite could not use the truncate optimization for, because they have triggers or, while foreign keys are
+    /// enforced, foreign keys or references. Their rows were deleted one by one, which takes time proportional to the
+    /// number of rows.
+    std::vector<std::string> slow_tables;
+    std::int64_t pages_vacuumed{0};
+};
+
 class ConnectionInterface {
 public:
     virtual ~ConnectionInterface() = default;
@@ -40,22 +116,58 @@ public:
     virtual bool close_connection() = 0;
 
     /// \brief Start a transaction on the database. Returns an object holding the transaction.
-    /// \note This function can block until the previous transaction is finished.
+    /// \note This function can block until the previous transaction of another thread is finished. If the calling
+    /// thread already holds a transaction, a nested transaction is started as a SAVEPOINT: committing it releases the
+    /// savepoint, rolling it back only undoes the changes since it was started. Nested transactions must be finished
+    /// before the transaction enclosing them.
     [[nodiscard]] virtual std::unique_ptr<TransactionInterface> begin_transaction() = 0;
 
+    /// \brief Like begin_transaction(), but waits for the previous transaction with TransactionOptions::priority and
+    /// at most TransactionOptions::timeout, and begins it in TransactionOptions::mode.
+    /// \note Will throw a QueryExecutionException if the transaction can't be begun, e.g. Immediate mode with the
+    /// database locked by another process
+    /// \return The transaction, or nullptr if the timeout passed before the previous transaction finished
+    /// \note The default implementation calls begin_transaction() for default \p options and throws a
+    /// QueryExecutionException for all others
+    [[nodiscard]] virtual std::unique_ptr<TransactionInterface> begin_transaction(const TransactionOptions& options);
+
     /// \brief Immediately executes \p statement. Returns true if succeeded.
+    /// \note An interrupted statement returns false as well, Connection::get_query_interrupt_stats() counts the causes
     virtual bool execute_statement(const std::string& statement) = 0;
 
+    /// \brief Executes the single statement \p sql with \p args bound to its parameters 1..N. The statement is
+    /// prepared through new_statement(), so repeated calls with the same \p sql are not parsed again. Result rows are
+    /// discarded. All types supported by bind_value can be used as arguments.
+    /// \note Will throw a QueryExecutionException if the statement can't be prepared or executed, a
+    /// QueryInterruptedException if it was interrupted
+    template <typename... Args> ExecuteResult execute(const std::string& sql, const Args&... args);
+
     /// \brief Returns a new StatementInterface to be used to perform more advanced sql statements.
     /// \note Will throw an std::runtime_error if the statement can't be prepared
     virtual std::unique_ptr<StatementInterface> new_statement(const std::string& sql) = 0;
 
+    /// \brief Opens the BLOB in \p column of the row with \p rowid in \p table for incremental reading and writing.
+    /// \note Will throw a QueryExecutionException if the BLOB can't be opened, which the default implementation always
+    /// does
+    virtual std::unique_ptr<BlobStreamInterface> open_blob(const std::string& table, const std::string& column,
+                                                           int64_t rowid, bool writable);
+
     /// \brief Returns the latest error message from sqlite3.
     virtual const char* get_error_message() = 0;
 
     /// \brief Clears the table with name \p table. Returns true if succeeded.
+    /// \note \p table is inserted into the SQL as is. Prefer truncate_tables(), which quotes the names, clears several
+    /// tables at once and can return the free pages to the file system.
     virtual bool clear_table(const std::string& table) = 0;
 
+    /// \brief Deletes all rows of \p tables in one transaction, so either all or none of them are cleared. Tables are
+    /// cleared by dropping their pages at once if SQLite can use its truncate optimization for them, otherwise row by
+    /// row, which is reported in TruncateResult::slow_tables.
+    /// \note Will throw a QueryExecutionException if a table can't be cleared, no table is changed in that case. Like
+    /// begin_transaction() this blocks until the previous transaction of another thread is finished, inside a
+    /// transaction of the calling thread it uses a savepoint. The default implementation always throws.
+    virtual TruncateResult truncate_tables(const std::vector<std::string>& tables, const TruncateOptions& options = {});
+
     /// \brief Gets the last inserted rowid.
     virtual int64_t get_last_inserted_rowid() = 0;
 
@@ -64,38 +176,185 @@ public:
 
     /// \brief Helper function to get the user version of the database.
     virtual uint32_t get_user_version() = 0;
+
+    /// \brief Returns the current value of the run-time limit \p limit_id, e.g. SQLITE_LIMIT_VARIABLE_NUMBER
+    /// \return -1 if the limit is not known, which is what implementations not backed by SQLite return by default
+    virtual int get_limit(int /*limit_id*/) {
+        return -1;
+    }
+
+    /// \brief Returns the page cache and memory counters of the connection. Counters of events like cache hits are
+    /// reset after reading if \p reset is set, values describing the current state are never reset. The default
+    /// implementation returns all counters as zero.
+    virtual ConnectionStats stats(bool reset = false);
+
+    /// \brief Replaces the content of the open database with the content of the database file at
+    /// \p source_file_path using the SQLite online backup API. The user version is copied as well.
+    /// \return True on success, false if the source can't be opened or the copy failed. The database is not changed
+    /// when the copy fails. The default implementation always fails.
+    virtual bool restore_from(const fs::path& source_file_path);
+
+    /// \brief Copies the open database to \p destination_file_path on a background thread using the SQLite online
+    /// backup API. Pages are copied in batches of BackupOptions::pages_per_step and other writers can access the
+    /// database between the batches. The copy is written next to the destination and renamed once it is complete, so
+    /// \p destination_file_path always holds either the previous or a complete new backup.
+    /// \return Future that becomes true once the backup is complete, false if it was cancelled, or holds a
+    /// BackupException if it failed, which the default implementation always does
+    virtual std::future<bool> backup_to(const fs::path& destination_file_path, const BackupOptions& options = {});
 };
 
+template <typename... Args> ExecuteResult ConnectionInterface::execute(const std::string& sql, const Args&... args) {
+    auto statement = this->new_statement(sql);
+    if (bind_values(*statement, 1, std::forward_as_tuple(args...)) != SQLITE_OK) {
+        throw QueryExecutionException(std::string{"Could not bind parameters: "} + this->get_error_message());
+    }
+    int result = statement->step();
+    while (result == SQLITE_ROW) {
+        result = statement->step();
+    }
+    if (result == SQLITE_INTERRUPT) {
+        throw QueryInterruptedException(std::string{"Statement was interrupted: "} + sql);
+    }
+    if (result != SQLITE_DONE) {
+        throw QueryExecutionException(std::string{"Could not execute statement: "} + this->get_error_message());
+    }
+    return {statement->changes(), this->get_last_inserted_rowid()};
+}
+
 class Connection : public ConnectionInterface {
 private:
+    friend class DatabaseTransaction;
+    friend class SavepointTransaction;
+    friend class QueryGuard;
+
     sqlite3* db;
     const fs::path database_file_path;
+    const ConnectionOptions options;
     std::atomic_uint32_t open_count;
-    std::timed_mutex transaction_mutex;
+    PriorityTimedMutex transaction_mutex;
+    std::atomic<std::thread::id> transaction_owner; ///< Thread holding transaction_mutex through a transaction
+    std::size_t savepoint_depth;                    ///< Nested transactions, only used by transaction_owner
+    StatementCache statement_cache;
+    std::mutex profiler_mutex;
+    std::unique_ptr<QueryProfiler> profiler; ///< Created on first use and kept until destruction, SQLite points to it
+    bool profiling_enabled;
+    std::mutex backup_mutex;
+    std::condition_variable backup_finished;
+    std::size_t running_backups;
+    std::atomic_bool destroying; ///< Cancels running backups, the destructor waits for them
+    std::mutex snapshot_mutex;   ///< Held while writing a snapshot of an in-memory database
+    std::condition_variable snapshot_stop_requested;
+    bool snapshot_stop;
+    std::thread snapshot_thread;
+    std::atomic_uint64_t commit_count; ///< Commits of an in-memory database, counted by a commit hook
+    std::uint64_t snapshot_commit_count;
+    std::unique_ptr<CheckpointScheduler> checkpoint_scheduler; ///< Set if ConnectionOptions::checkpoint is set
+    QueryLimiter query_limiter;
+    std::unique_ptr<BusyHandler> busy_handler; ///< Set if ConnectionOptions::busy_retry is set
 
     bool close_connection_internal(bool force_close);
+    /// \brief Executes \p sql without a deadline and returns the SQLite result code, errors are logged
+    int execute_sql(const std::string& sql);
+    bool backup(const fs::path& destination_file_path, const BackupOptions& options);
+    bool load_snapshot();
+    bool write_snapshot();
+    void run_snapshot_flushes(std::chrono::milliseconds interval);
 
 public:
     explicit Connection(const fs::path& database_file_path) noexcept;
 
+    /// \brief Creates a connection that applies \p options when it is opened
+    Connection(const fs::path& database_file_path, const ConnectionOptions& options) noexcept;
+
     ~Connection() override;
 
+    /// \copydoc ConnectionInterface::open_connection
+    /// \note Fails and leaves the connection closed if any of the ConnectionOptions can't be applied
     bool open_connection() override;
     bool close_connection() override;
 
+    /// \brief Returns the options this connection is opened with
+    const ConnectionOptions& get_options() const;
+
+    /// \brief Atomically replaces the database file with a snapshot of the in-memory database, see
+    /// ConnectionOptions::in_memory_snapshot. Does nothing if there were no commits since the last snapshot.
+    /// \return True if the file is up to date, false if the connection is not in hybrid in-memory mode, is closed, a
+    /// transaction is open or the file could not be written
+    bool flush_snapshot();
+
+    /// \brief Returns the counters of the background WAL checkpoints, see ConnectionOptions::checkpoint. The
+    /// counters are kept when the connection is closed and opened again, all are zero if the option is not set.
+    CheckpointStats get_checkpoint_stats() const;
+
+    /// \brief Interrupts all statements currently running on this connection, they fail with SQLITE_INTERRUPT. Can be
+    /// called from any thread. Statements started afterwards are not affected.
+    /// \note SQLite rolls back the open transaction if an INSERT, UPDATE or DELETE in it is interrupted
+    void interrupt();
+
+    /// \brief Returns how often statements were interrupted by deadlines, see QueryGuard and
+    /// ConnectionOptions::query_timeout, by cancellation and by interrupt()
+    QueryInterruptStats get_query_interrupt_stats() const;
+
+    /// \brief Returns how often locks held by other connections were retried, see ConnectionOptions::busy_retry. All
+    /// counters are zero if the option is not set.
+    BusyStats get_busy_stats() const;
+
+    /// \brief Returns the time transactions waited for the previous transaction to finish, per priority
+    TransactionLockStats get_transaction_lock_stats();
+
     [[nodiscard]] std::unique_ptr<TransactionInterface> begin_transaction() override;
+    [[nodiscard]] std::unique_ptr<TransactionInterface> begin_transaction(const TransactionOptions& options) override;
 
     bool execute_statement(const std::string& statement) override;
+
+    /// \copydoc ConnectionInterface::new_statement
+    /// \note Statements are served from a per-connection LRU cache keyed by \p sql. When the returned statement is
+    /// destroyed it is reset, its bindings are cleared and it is kept prepared for the next call with the same \p sql.
     std::unique_ptr<StatementInterface> new_statement(const std::string& sql) override;
 
+    std::unique_ptr<BlobStreamInterface> open_blob(const std::string& table, const std::string& column, int64_t rowid,
+                                                   bool writable) override;
+
+    /// \brief Changes the number of prepared statements kept by new_statement(). 0 disables the cache.
+    void set_statement_cache_capacity(std::size_t capacity);
+
+    /// \brief Returns the hit/miss counters of the statement cache used by new_statement()
+    StatementCacheStats get_statement_cache_stats() const;
+
+    /// \brief Starts collecting latency histograms, row and call counts per SQL text, and logging queries that reach
+    /// QueryProfilerOptions::slow_query_threshold. Profiling stays enabled if the connection is closed and opened
+    /// again.
+    /// \note Profiling is off by default and costs nothing while disabled
+    void enable_query_profiling(const QueryProfilerOptions& options = {});
+
+    /// \brief Stops collecting measurements, the collected ones are kept until retrieved with reset
+    void disable_query_profiling();
+
+    /// \brief Returns the measurements collected since profiling was first enabled or last reset
+    QueryProfile get_query_profile(bool reset = false);
+
     const char* get_error_message() override;
 
     bool clear_table(const std::string& table) override;
 
+    TruncateResult truncate_tables(const std::vector<std::string>& tables,
+                                   const TruncateOptions& options = {}) override;
+
     int64_t get_last_inserted_rowid() override;
 
     uint32_t get_user_version() override;
     void set_user_version(uint32_t version) override;
+
+    int get_limit(int limit_id) override;
+
+    ConnectionStats stats(bool reset = false) override;
+
+    bool restore_from(const fs::path& source_file_path) override;
+
+    /// \copydoc ConnectionInterface::backup_to
+    /// \note The backup uses this connection, which must use the serialized threading mode (no SQLITE_OPEN_NOMUTEX).
+    /// The connection is kept open until the backup is finished and the destructor cancels running backups.
+    std::future<bool> backup_to(const fs::path& destination_file_path, const BackupOptions& options = {}) override;
 };
 
 } // namespace everest::db::sqlite
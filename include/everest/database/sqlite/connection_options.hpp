@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <sqlite3.h>
+
+#include <everest/database/sqlite/statement_cache.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Values of PRAGMA journal_mode
+enum class JournalMode {
+    Delete,
+    Truncate,
+    Persist,
+    Memory,
+    Wal,
+    Off
+};
+
+/// \brief Values of PRAGMA synchronous
+enum class SynchronousMode {
+    Off,
+    Normal,
+    Full,
+    Extra
+};
+
+/// \brief Values of PRAGMA temp_store
+enum class TempStore {
+    Default,
+    File,
+    Memory
+};
+
+/// \brief Values of PRAGMA auto_vacuum
+enum class AutoVacuum {
+    None,
+    Full,
+    Incremental
+};
+
+/// \brief Values of PRAGMA locking_mode
+enum class LockingMode {
+    Normal,
+    Exclusive
+};
+
+/// \brief Modes of sqlite3_wal_checkpoint_v2
+enum class CheckpointMode {
+    Passive,  ///< Copies as many frames as possible without waiting for readers or writers
+    Full,     ///< Waits for writers, then copies all frames
+    Restart,  ///< Like Full, and waits for readers so the next writer starts at the beginning of the WAL
+    Truncate  ///< Like Restart, and truncates the WAL file to zero bytes
+};
+
+/// \brief Settings of the background WAL checkpoints of a connection, see ConnectionOptions::checkpoint
+struct CheckpointOptions {
+    /// Time without commits after which pending WAL frames are copied to the database with a passive checkpoint
+    std::chrono::milliseconds idle_time{std::chrono::milliseconds(500)};
+    /// Size of the WAL file in bytes at which escalation_mode is used, regardless of whether the connection is idle
+    std::uint64_t wal_size_limit{16 * 1024 * 1024};
+    /// Checkpoint used once the WAL reaches wal_size_limit, should be Restart or Truncate so the WAL stops growing
+    CheckpointMode escalation_mode{CheckpointMode::Truncate};
+    /// Time an escalated checkpoint waits for readers and writers to finish
+    std::chrono::milliseconds escalation_timeout{std::chrono::seconds(1)};
+};
+
+/// \brief Settings of the busy handler of a connection, see ConnectionOptions::busy_retry
+struct BusyRetryOptions {
+    /// Delay before the first retry, doubled (see multiplier) for every further retry of the same lock
+    std::chrono::milliseconds initial_delay{std::chrono::milliseconds(1)};
+    /// Upper bound of a single delay
+    std::chrono::milliseconds max_delay{std::chrono::milliseconds(100)};
+    double multiplier{2.0};
+    /// Every delay is shortened by a random fraction of up to this, so competing processes don't retry in lockstep
+    double jitter{0.5};
+    /// Total time waited for one lock before SQLITE_BUSY is returned
+    std::chrono::milliseconds timeout{std::chrono::seconds(5)};
+};
+
+/// \brief Settings of a database that is kept in memory and written to its file as a whole (hybrid in-memory mode)
+struct InMemorySnapshotOptions {
+    /// Interval in which changes are written to the file, 0 only writes them on close and Connection::flush_snapshot().
+    /// This is the maximum time of changes lost on power loss.
+    std::chrono::milliseconds flush_interval{std::chrono::seconds(10)};
+};
+
+/// \brief Settings applied when a connection is opened. Settings that are not set keep the SQLite default.
+struct ConnectionOptions {
+    /// Flags passed to sqlite3_open_v2, e.g. add SQLITE_OPEN_NOMUTEX for connections used by a single thread
+    int open_flags{SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI};
+    std::optional<JournalMode> journal_mode;
+    std::optional<SynchronousMode> synchronous;
+    /// Maximum number of bytes of the database file that are memory mapped
+    std::optional<std::int64_t> mmap_size;
+    /// Page cache size, number of pages if positive and KiB if negative (same as PRAGMA cache_size)
+    std::optional<int> cache_size;
+    /// Page size in bytes, only has an effect on new databases or after a VACUUM in non-WAL mode
+    std::optional<int> page_size;
+    /// Whether free pages are returned to the file system. Like the page size this can only be changed on new
+    /// databases or with a VACUUM in non-WAL mode. Incremental is needed to reclaim space with PRAGMA
+    /// incremental_vacuum, e.g. by the RetentionManager.
+    std::optional<AutoVacuum> auto_vacuum;
+    std::optional<TempStore> temp_store;
+    std::optional<std::chrono::milliseconds> busy_timeout;
+    /// Retries locked by other connections or processes with jittered exponential backoff instead of the fixed sleeps
+    /// of busy_timeout. Replaces busy_timeout when both are set.
+    std::optional<BusyRetryOptions> busy_retry;
+    std::optional<LockingMode> locking_mode;
+    /// Number of prepared statements kept by Connection::new_statement(), 0 disables the cache
+    std::size_t statement_cache_capacity{DEFAULT_STATEMENT_CACHE_CAPACITY};
+    /// Keeps the database in memory: it is loaded from the database file on open and the file is atomically replaced
+    /// with a snapshot periodically, on close and on demand. The journal mode, memory mapping and locking mode don't
+    /// apply to in-memory databases and are ignored. Opening fails if open_flags contain SQLITE_OPEN_NOMUTEX, since
+    /// snapshots are taken on another thread.
+    std::optional<InMemorySnapshotOptions> in_memory_snapshot;
+    /// Replaces the automatic checkpoint, which runs inside whichever commit crosses the threshold, with checkpoints on
+    /// a background thread. Requires the database to be in WAL mode, ignored in hybrid in-memory mode.
+    std::optional<CheckpointOptions> checkpoint;
+    /// Deadline for every execution of a statement returned by new_statement(), counted from its first step(), and
+    /// for every execute_statement() call. Statements still running after it are interrupted, see QueryGuard. Only the
+    /// statement that exceeded it is interrupted, long transactions of short statements are not.
+    std::optional<std::chrono::milliseconds> query_timeout;
+
+    /// \brief WAL with synchronous NORMAL and temporary data in memory. Keeps writes and syncs to eMMC/SD-cards low
+    /// while staying safe against corruption on power loss (the last transactions may be lost).
+    static ConnectionOptions flash_friendly();
+
+    /// \brief WAL with synchronous NORMAL, a large page cache and memory mapped I/O for maximum query throughput
+    static ConnectionOptions max_throughput();
+
+    /// \brief In-memory journal without syncing, intended for unit tests on in-memory databases
+    static ConnectionOptions in_memory_test();
+};
+
+/// \brief Applies \p options (except ConnectionOptions::open_flags) to the open database \p db and verifies them by
+/// reading back the PRAGMAs.
+/// \return True if all settings are active, false otherwise. The reason is logged.
+bool apply_connection_options(sqlite3* db, const ConnectionOptions& options);
+
+} // namespace everest::db::sqlite
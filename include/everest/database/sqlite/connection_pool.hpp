@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <condition_variable>
+#include <vector>
+
+#include <everest/database/sqlite/connection.hpp>
+
+namespace everest::db::sqlite {
+
+class ConnectionPool;
+
+/// \brief Exclusive handle on one reader connection of a ConnectionPool. The reader is returned to the pool when the
+/// lease is destroyed.
+/// \note Statements created from a lease must be destroyed before the lease itself. A lease must only be used by one
+/// thread at a time since reader connections are opened without the SQLite internal mutex. A lease must not outlive
+/// the pool object, but it stays usable when the pool is closed, its reader is closed once the lease is destroyed.
+class ReaderLease {
+private:
+    friend class ConnectionPool;
+    friend class ReadSnapshot;
+    struct Reader;
+
+    ConnectionPool* pool;
+    Reader* reader;
+
+    ReaderLease(ConnectionPool* pool, Reader* reader) noexcept;
+
+public:
+    ReaderLease(ReaderLease&& other) noexcept;
+    ReaderLease& operator=(ReaderLease&& other) noexcept;
+    ReaderLease(const ReaderLease&) = delete;
+    ReaderLease& operator=(const ReaderLease&) = delete;
+    ~ReaderLease();
+
+    /// \brief Returns a new read-only statement on the leased reader connection.
+    /// \note Will throw a QueryExecutionException if the statement can't be prepared
+    std::unique_ptr<StatementInterface> new_statement(const std::string& sql);
+
+    /// \brief Opens a BLOB for incremental reading on the leased reader connection.
+    /// \note Will throw a QueryExecutionException if the BLOB can't be opened
+    std::unique_ptr<BlobStreamInterface> open_blob(const std::string& table, const std::string& column,
+                                                   int64_t rowid);
+
+    /// \brief Returns the latest error message from sqlite3 for the leased reader connection.
+    const char* get_error_message();
+};
+
+/// \brief Read transaction on a leased reader connection. All statements of the snapshot see the database as it was
+/// when the snapshot was begun, writes committed afterwards are not visible. The transaction ends and the reader is
+/// returned to its pool when the snapshot is destroyed.
+/// \note The snapshot keeps checkpoints from copying frames written after it began, so the WAL can't be reset while it
+/// exists. Keep snapshots short lived.
+class ReadSnapshot {
+private:
+    friend class ConnectionPool;
+
+    ReaderLease lease;
+
+    explicit ReadSnapshot(ReaderLease lease);
+
+public:
+    ReadSnapshot(ReadSnapshot&& other) noexcept = default;
+    ReadSnapshot& operator=(ReadSnapshot&& other) = delete;
+    ReadSnapshot(const ReadSnapshot&) = delete;
+    ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+    ~ReadSnapshot();
+
+    /// \brief Returns a new read-only statement reading from the snapshot
+    /// \note Will throw a QueryExecutionException if the statement can't be prepared
+    std::unique_ptr<StatementInterface> new_statement(const std::string& sql);
+
+    /// \brief Opens a BLOB of the snapshot for incremental reading
+    /// \note Will throw a QueryExecutionException if the BLOB can't be opened
+    std::unique_ptr<BlobStreamInterface> open_blob(const std::string& table, const std::string& column,
+                                                   int64_t rowid);
+
+    /// \brief Returns the latest error message from sqlite3 for the reader connection of the snapshot
+    const char* get_error_message();
+
+    /// \brief Ends the read transaction and returns the reader to its pool. The snapshot can't be used afterwards.
+    void end();
+};
+
+/// \brief Database connection that puts the database in WAL mode and keeps one writer connection plus a number of
+/// read-only connections. Readers never wait on the writer, so long reads don't stall writes and scale across cores.
+///
+/// All ConnectionInterface functions are executed on the writer connection, so existing consumers like the
+/// SchemaUpdater keep working unchanged. Reads that should run concurrently use acquire_reader().
+/// \note Only file databases are supported, in-memory databases can't be shared between connections in WAL mode
+class ConnectionPool : public ConnectionInterface {
+private:
+    friend class ReaderLease;
+
+    Connection writer;
+    const fs::path database_file_path;
+    const ConnectionOptions reader_options;
+    const std::size_t reader_count;
+    std::atomic_uint32_t open_count;
+
+    std::mutex readers_mutex;
+    std::condition_variable reader_returned;
+    std::vector<std::unique_ptr<ReaderLease::Reader>> readers;
+    std::vector<ReaderLease::Reader*> idle_readers;
+    /// \brief Readers that were still leased when the pool was closed, they are closed once they are returned
+    std::vector<std::unique_ptr<ReaderLease::Reader>> closed_readers;
+
+    bool open_readers();
+    void close_readers();
+    void release_reader(ReaderLease::Reader* reader);
+
+public:
+    /// \brief Creates a pool for the database at \p database_file_path with \p reader_count read-only connections
+    ConnectionPool(const fs::path& database_file_path, std::size_t reader_count) noexcept;
+
+    /// \brief Creates a pool that applies \p options to its connections. The journal mode is always WAL. Readers only
+    /// take over the settings that apply to read-only connections (cache, mmap, temp_store, busy timeout) and are
+    /// opened with SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX.
+    ConnectionPool(const fs::path& database_file_path, std::size_t reader_count,
+                   const ConnectionOptions& options) noexcept;
+
+    ~ConnectionPool() override;
+
+    bool open_connection() override;
+    bool close_connection() override;
+
+    [[nodiscard]] std::unique_ptr<TransactionInterface> begin_transaction() override;
+    [[nodiscard]] std::unique_ptr<TransactionInterface> begin_transaction(const TransactionOptions& options) override;
+
+    bool execute_statement(const std::string& statement) override;
+    std::unique_ptr<StatementInterface> new_statement(const std::string& sql) override;
+    std::unique_ptr<BlobStreamInterface> open_blob(const std::string& table, const std::string& column, int64_t rowid,
+                                                   bool writable) override;
+
+    const char* get_error_message() override;
+
+    bool clear_table(const std::string& table) override;
+
+    TruncateResult truncate_tables(const std::vector<std::string>& tables,
+                                   const TruncateOptions& options = {}) override;
+
+    int64_t get_last_inserted_rowid() override;
+
+    uint32_t get_user_version() override;
+    void set_user_version(uint32_t version) override;
+
+    int get_limit(int limit_id) override;
+
+    /// \copydoc ConnectionInterface::stats
+    /// \note Only covers the writer connection
+    ConnectionStats stats(bool reset = false) override;
+
+    /// \copydoc ConnectionInterface::restore_from
+    /// \note Restores through the writer, readers see the new content with their next query
+    bool restore_from(const fs::path& source_file_path) override;
+
+    /// \copydoc ConnectionInterface::backup_to
+    /// \note Backs up through the writer
+    std::future<bool> backup_to(const fs::path& destination_file_path, const BackupOptions& options = {}) override;
+
+    /// \brief Checks out a reader connection. Blocks until one is available.
+    /// \note Will throw a ConnectionException if the pool is not open
+    ReaderLease acquire_reader();
+
+    /// \brief Checks out a reader connection and begins a read transaction on it, so several queries see one consistent
+    /// state of the database. Does not wait for or block the writer. Blocks until a reader is available.
+    /// \note Will throw a ConnectionException if the pool is not open and a QueryExecutionException if the read
+    /// transaction can't be begun
+    ReadSnapshot begin_read_snapshot();
+
+    /// \brief Returns the number of reader connections of the pool
+    std::size_t get_reader_count() const;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <thread>
+
+#include <everest/database/sqlite/connection.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Limits that decide when a group of small write transactions is committed
+struct GroupCommitOptions {
+    /// Maximum time a submitted unit of work waits for its commit. This is the maximum data-loss window on power loss.
+    std::chrono::milliseconds max_delay{50};
+    /// Maximum number of units of work that are merged into one physical transaction
+    std::size_t max_transactions{64};
+};
+
+/// \brief Counters describing the work done by a GroupCommit
+struct GroupCommitStats {
+    std::uint64_t commits{0};         ///< Number of physical transactions committed
+    std::uint64_t units_committed{0}; ///< Number of units of work that are durable
+    std::uint64_t units_failed{0};    ///< Number of units of work that threw or were part of a failed commit
+    std::size_t largest_group{0};     ///< Largest number of units merged into one physical transaction
+};
+
+/// \brief Merges logically independent small write transactions from many threads into one physical transaction.
+///
+/// Each unit of work runs inside its own SAVEPOINT on a background thread, so a failing unit is rolled back without
+/// affecting the others of its group. The group is committed when either GroupCommitOptions::max_delay has passed since
+/// the first unit was submitted or GroupCommitOptions::max_transactions units are collected. This trades a bounded
+/// data-loss window for far fewer journal syncs.
+/// \note While a group is open the database transaction lock is held, other begin_transaction() calls wait for it
+class GroupCommit {
+public:
+    /// \brief Unit of work executed inside the shared transaction. Throwing rolls back only this unit.
+    using Work = std::function<void(ConnectionInterface&)>;
+
+private:
+    struct Unit {
+        Work work;
+        std::promise<void> committed;
+        std::chrono::steady_clock::time_point submitted;
+        bool flush;
+    };
+
+    ConnectionInterface* database;
+    const GroupCommitOptions options;
+
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_changed;
+    std::deque<Unit> queue;
+    bool running;
+    GroupCommitStats stats;
+    std::thread worker;
+
+    void run();
+    void commit_group(std::chrono::steady_clock::time_point deadline, std::unique_lock<std::mutex>& lock);
+
+public:
+    /// \brief Starts the background thread committing groups on \p database
+    /// \note \p database must be open and outlive this object
+    GroupCommit(ConnectionInterface* database, const GroupCommitOptions& options);
+
+    /// \brief Commits all pending units and stops the background thread
+    ~GroupCommit();
+
+    GroupCommit(const GroupCommit&) = delete;
+    GroupCommit& operator=(const GroupCommit&) = delete;
+
+    /// \brief Queues \p work to be executed in the next group.
+    /// \return Future that becomes ready once the group containing \p work is committed, or holds the exception that
+    /// made \p work or the commit fail
+    std::future<void> submit(Work work);
+
+    /// \brief Commits the currently open group without waiting for the limits to be reached
+    /// \return Future that becomes ready once all previously submitted units are committed, or holds the exception
+    /// that made the transaction of the group fail to begin or commit
+    std::future<void> flush();
+
+    /// \brief Returns a snapshot of the group commit counters
+    GroupCommitStats get_stats() const;
+};
+
+} // namespace everest::db::sqlite
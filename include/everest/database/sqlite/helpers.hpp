@@ -4,9 +4,25 @@
 #pragma once
 
 #include <limits>
+#include <string>
+#include <string_view>
 
 namespace everest::db::sqlite {
 template <typename T, typename U> T constexpr clamp_to(U len) {
     return (len <= std::numeric_limits<T>::max()) ? static_cast<T>(len) : std::numeric_limits<T>::max();
 }
+
+/// \brief Returns \p identifier as a quoted SQL identifier, for table and column names that can't be bound as
+/// parameters
+inline std::string quote_identifier(std::string_view identifier) {
+    std::string quoted{"\""};
+    for (const char c : identifier) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
 } // namespace everest::db::sqlite
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace everest::db::sqlite {
+
+/// \brief Order in which threads waiting for a PriorityTimedMutex are admitted
+enum class TransactionPriority {
+    Critical,   ///< E.g. session start or stop, admitted before all other waiters
+    Normal,     ///< Default of all transactions
+    Background, ///< E.g. log flushes or retention, only admitted when no one else waits
+};
+
+/// \brief Lock wait counters of one TransactionPriority
+struct LockWaitStats {
+    std::uint64_t acquisitions{0};                ///< Successful lock calls
+    std::uint64_t timeouts{0};                    ///< Lock calls that gave up at their deadline
+    std::chrono::microseconds total_wait_time{0}; ///< Sum of the waits of all lock calls, including timed out ones
+    std::chrono::microseconds max_wait_time{0};   ///< Longest wait of a single lock call
+};
+
+/// \brief Lock wait counters of a PriorityTimedMutex per TransactionPriority
+struct TransactionLockStats {
+    LockWaitStats critical;
+    LockWaitStats normal;
+    LockWaitStats background;
+};
+
+/// \brief Timed mutex that admits waiting threads by priority: when the mutex is released, a waiting Critical thread
+/// gets it before all Normal ones, and those before all Background ones. Threads of the same priority are admitted in
+/// no particular order.
+///
+/// lock(), try_lock() and try_lock_for() make it usable with std::unique_lock, they use TransactionPriority::Normal.
+/// \note A continuous stream of higher priority lock calls starves lower priority waiters, use deadlines for them
+class PriorityTimedMutex {
+private:
+    std::mutex state_mutex;
+    std::condition_variable state_changed;
+    bool locked;
+    std::array<std::size_t, 3> waiting; ///< Number of waiting threads per priority
+    std::array<LockWaitStats, 3> stats;
+
+    /// \brief Returns true if the mutex is free and no thread with a higher priority than \p priority waits for it
+    bool can_acquire(TransactionPriority priority) const;
+    void record_wait(TransactionPriority priority, std::chrono::steady_clock::duration wait_time, bool acquired);
+
+public:
+    PriorityTimedMutex();
+    PriorityTimedMutex(const PriorityTimedMutex&) = delete;
+    PriorityTimedMutex& operator=(const PriorityTimedMutex&) = delete;
+
+    /// \brief Blocks until the mutex is acquired
+    void lock();
+
+    /// \brief Acquires the mutex if it is free and no one waits for it, never blocks
+    bool try_lock();
+
+    /// \brief Blocks until the mutex is acquired or \p timeout passed
+    /// \return True if the mutex was acquired
+    template <typename Rep, typename Period> bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return this->lock(TransactionPriority::Normal, std::chrono::steady_clock::now() + timeout);
+    }
+
+    /// \brief Blocks until the mutex is acquired with \p priority or \p deadline passed, without a deadline until it is
+    /// acquired
+    /// \return True if the mutex was acquired
+    bool lock(TransactionPriority priority,
+              const std::optional<std::chrono::steady_clock::time_point>& deadline = std::nullopt);
+
+    void unlock();
+
+    /// \brief Returns the lock wait counters of all priorities
+    TransactionLockStats get_stats();
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include <sqlite3.h>
+
+#include <everest/database/sqlite/cancellation_token.hpp>
+
+namespace everest::db::sqlite {
+
+class Connection;
+
+/// \brief Number of SQLite virtual machine operations between two checks of the deadlines and cancellation tokens of a
+/// statement. Statements shorter than this are never interrupted by a deadline.
+constexpr int QUERY_LIMIT_CHECK_INTERVAL = 1000;
+
+/// \brief Counters of the statements interrupted on a connection
+struct QueryInterruptStats {
+    std::uint64_t deadlines_exceeded{0}; ///< Statements interrupted because a deadline passed
+    std::uint64_t cancellations{0};      ///< Statements interrupted because a CancellationToken was cancelled
+    std::uint64_t interrupts{0};         ///< Calls of Connection::interrupt()
+};
+
+/// \brief Interrupts a running statement of a connection once a deadline or CancellationToken registered by the thread
+/// stepping it expires, using sqlite3_progress_handler. Interrupted statements fail with SQLITE_INTERRUPT.
+///
+/// Limits are registered per thread, the progress handler runs on the thread stepping the statement and only checks
+/// the limits of that thread without locking.
+/// \note Used by Connection, Statement and QueryGuard, not meant to be used directly
+class QueryLimiter {
+public:
+    struct Limit {
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        std::optional<CancellationToken> cancellation;
+    };
+
+private:
+    std::mutex database_mutex; ///< Keeps the attached connection open while interrupt() uses it
+    sqlite3* database;         ///< Attached connection, guarded by database_mutex
+    std::optional<std::chrono::milliseconds> statement_timeout;
+    std::atomic_uint64_t deadlines_exceeded;
+    std::atomic_uint64_t cancellations;
+    std::atomic_uint64_t interrupts;
+
+    static int progress_handler(void* context);
+    bool check_limits();
+
+public:
+    QueryLimiter();
+    ~QueryLimiter();
+
+    QueryLimiter(const QueryLimiter&) = delete;
+    QueryLimiter& operator=(const QueryLimiter&) = delete;
+
+    /// \brief Installs the progress handler on \p db
+    void attach(sqlite3* db);
+
+    /// \brief Removes the progress handler, must be called before the attached connection is closed
+    void detach();
+
+    /// \brief Interrupts all statements currently running on the attached connection, see sqlite3_interrupt
+    void interrupt();
+
+    /// \brief Sets the timeout of every statement execution, see ConnectionOptions::query_timeout. Must be set before
+    /// statements are stepped.
+    void set_statement_timeout(std::optional<std::chrono::milliseconds> timeout);
+
+    /// \brief Returns the deadline of a statement execution starting now, if there is a statement timeout
+    std::optional<std::chrono::steady_clock::time_point> statement_deadline() const;
+
+    /// \brief Registers \p limit for statements stepped by the calling thread until remove() is called by it
+    void add(const Limit& limit);
+    void remove(const Limit& limit);
+
+    QueryInterruptStats get_stats() const;
+};
+
+/// \brief Bounds the time statements run on a connection while the guard exists. Once \p timeout passed or
+/// \p cancellation is cancelled, statements the creating thread steps on the connection fail with SQLITE_INTERRUPT,
+/// which ConnectionInterface::execute() and RowRange report as QueryInterruptedException.
+///
+/// Guards can be nested, the statements are interrupted as soon as any of them expires.
+/// \note The guard only applies to statements stepped by the thread that created it, statements of other threads on
+/// the same connection are not affected. It must be destroyed by that thread. Limits are checked every
+/// QUERY_LIMIT_CHECK_INTERVAL virtual machine operations.
+class QueryGuard {
+private:
+    QueryLimiter* limiter;
+    const QueryLimiter::Limit limit;
+
+public:
+    /// \brief Interrupts statements on \p connection after \p timeout
+    QueryGuard(Connection& connection, std::chrono::milliseconds timeout);
+
+    /// \brief Interrupts statements on \p connection once \p cancellation is cancelled or, if set, \p timeout passed
+    QueryGuard(Connection& connection, const CancellationToken& cancellation,
+               std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /// \brief Guard registered directly with \p limiter
+    QueryGuard(QueryLimiter& limiter, const QueryLimiter::Limit& limit);
+
+    ~QueryGuard();
+
+    QueryGuard(const QueryGuard&) = delete;
+    QueryGuard& operator=(const QueryGuard&) = delete;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace everest::db::sqlite {
+
+/// \brief Exclusive upper bounds in microseconds of the latency histogram buckets, the last bucket counts everything
+/// from the last bound on
+constexpr std::array<std::int64_t, 11> QUERY_LATENCY_BUCKET_BOUNDS_US{10,    50,     100,    500,    1000,   5000,
+                                                                      10000, 50000, 100000, 500000, 1000000};
+constexpr std::size_t QUERY_LATENCY_BUCKETS = QUERY_LATENCY_BUCKET_BOUNDS_US.size() + 1;
+
+/// \brief Settings of the query profiler of a connection
+struct QueryProfilerOptions {
+    /// Statements running at least this long are logged with their expanded SQL, zero disables the slow query log
+    std::chrono::microseconds slow_query_threshold{0};
+    /// Maximum number of distinct SQL texts that are tracked, further statements are only counted as untracked
+    std::size_t max_queries{256};
+};
+
+/// \brief Aggregated measurements of one SQL text
+struct QueryStats {
+    std::string sql;                        ///< SQL text as prepared, without bound values
+    std::uint64_t calls{0};                 ///< Number of completed executions
+    std::uint64_t rows{0};                  ///< Number of result rows stepped over all executions
+    std::chrono::nanoseconds total_time{0}; ///< Sum of the execution times
+    std::chrono::nanoseconds max_time{0};   ///< Longest execution time
+    /// Number of executions per latency bucket, see QUERY_LATENCY_BUCKET_BOUNDS_US
+    std::array<std::uint64_t, QUERY_LATENCY_BUCKETS> latency_histogram{};
+};
+
+/// \brief Snapshot of all measurements of a profiler
+struct QueryProfile {
+    std::vector<QueryStats> queries;  ///< Sorted by total_time, the most expensive first
+    std::uint64_t slow_queries{0};    ///< Number of executions that reached the slow query threshold
+    std::uint64_t untracked_calls{0}; ///< Executions not tracked because QueryProfilerOptions::max_queries was reached
+};
+
+/// \brief Collects per SQL text latency histograms, row and call counts through sqlite3_trace_v2.
+///
+/// Counters are updated with atomics, the map from SQL text to counters is only locked exclusively when a new SQL text
+/// is seen. The counters of a statement are looked up once when it starts executing, rows and the final profile event
+/// update them without locking or hashing the SQL text. Nothing is registered with SQLite while no connection is
+/// attached, so a disabled profiler has no overhead.
+/// \note Can only be attached to one connection at a time
+/// \note Execution times are measured with std::chrono::steady_clock from the first step of a statement to the end of
+/// its execution. The times SQLite reports are only used for statements that started before the profiler was attached,
+/// since the clock of the default unix VFS has a resolution of one millisecond.
+class QueryProfiler {
+private:
+    struct Entry {
+        std::string sql;
+        std::atomic_uint64_t calls{0};
+        std::atomic_uint64_t rows{0};
+        std::atomic_uint64_t total_ns{0};
+        std::atomic_uint64_t max_ns{0};
+        std::array<std::atomic_uint64_t, QUERY_LATENCY_BUCKETS> histogram{};
+
+        explicit Entry(std::string sql) : sql(std::move(sql)) {
+        }
+
+        /// \brief Records one execution that took \p elapsed_ns
+        void record(std::int64_t elapsed_ns);
+    };
+
+    std::atomic<std::int64_t> slow_query_threshold_ns;
+    std::atomic_size_t max_queries;
+    std::atomic_uint64_t slow_queries;
+    std::atomic_uint64_t untracked_calls;
+
+    /// \brief Entry of a statement between its first step and the end of its execution
+    struct RunningStatement {
+        sqlite3_stmt* stmt;
+        std::shared_ptr<Entry> entry; ///< Null if the SQL text is not tracked, kept alive by a reset
+        std::chrono::steady_clock::time_point started;
+    };
+
+    mutable std::shared_mutex entries_mutex;
+    /// Keys are views on Entry::sql
+    std::unordered_map<std::string_view, std::shared_ptr<Entry>> entries;
+    /// Only accessed from the trace callback, which SQLite serializes per connection, and while no callback is set
+    std::vector<RunningStatement> running;
+
+    static int trace_callback(unsigned int type, void* context, void* p, void* x);
+    void on_statement(sqlite3_stmt* stmt);
+    void on_profile(sqlite3_stmt* stmt, std::int64_t elapsed_ns);
+    void on_row(sqlite3_stmt* stmt);
+
+    /// \brief Returns the entry of \p sql, which is added if it is new
+    /// \return Null if \p sql is new but max_queries entries are tracked already
+    std::shared_ptr<Entry> find_entry(std::string_view sql);
+    std::vector<RunningStatement>::iterator find_running(sqlite3_stmt* stmt);
+
+public:
+    explicit QueryProfiler(const QueryProfilerOptions& options = {});
+
+    /// \brief Applies \p options, measurements already collected are kept
+    void set_options(const QueryProfilerOptions& options);
+
+    /// \brief Registers the profiler on \p db. The profiler must outlive the registration.
+    /// \return True if the trace callback could be registered
+    bool attach(sqlite3* db);
+
+    /// \brief Removes the trace callback from \p db
+    static void detach(sqlite3* db);
+
+    /// \brief Returns a snapshot of all measurements, optionally clearing them afterwards
+    QueryProfile snapshot(bool reset = false);
+};
+
+} // namespace everest::db::sqlite
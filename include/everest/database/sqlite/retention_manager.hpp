@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <everest/database/sqlite/cancellation_token.hpp>
+#include <everest/database/sqlite/connection.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief How the age column of a RetentionRule stores its timestamps
+enum class TimestampFormat {
+    UnixSeconds,      ///< Integer seconds since the epoch
+    UnixMilliseconds, ///< Integer milliseconds since the epoch
+    Iso8601           ///< UTC text like 2025-01-31T12:00:00.000Z, compared as text
+};
+
+/// \brief Limits that decide which rows of a table are deleted by a RetentionManager. Rows are deleted if they are
+/// older than max_age or are not among the newest max_rows rows, whichever deletes more.
+struct RetentionRule {
+    std::string table;
+    /// Column holding the time the row was written, required for max_age
+    std::string age_column;
+    TimestampFormat timestamp_format{TimestampFormat::UnixSeconds};
+    std::optional<std::chrono::seconds> max_age;
+    /// Maximum number of rows kept, the rows with the highest rowids are the newest. Must not be negative.
+    std::optional<std::int64_t> max_rows;
+};
+
+/// \brief Pacing and cancellation of RetentionManager::run()
+struct RetentionOptions {
+    /// Width of the rowid range deleted per transaction, must be positive
+    std::int64_t chunk_size{500};
+    /// Pause after every chunk and vacuum step that lets other writers access the database
+    std::chrono::milliseconds pause_between_chunks{10};
+    /// Number of free pages returned to the file system per PRAGMA incremental_vacuum, 0 disables vacuuming
+    int vacuum_pages_per_step{256};
+    /// Stops the run before the next chunk or vacuum step, chunks that are already deleted stay deleted
+    CancellationToken cancellation;
+};
+
+/// \brief Summary of one RetentionManager::run()
+struct RetentionResult {
+    std::uint64_t rows_deleted{0};
+    std::uint64_t chunks{0}; ///< Number of delete transactions
+    std::uint64_t pages_vacuumed{0};
+    bool cancelled{false};
+};
+
+/// \brief Keeps continuously growing tables like meter values, security events or message queues bounded.
+///
+/// Instead of one large DELETE that holds the write lock until it is done and grows the journal by the size of all
+/// deleted rows, rows are deleted in rowid ranges of RetentionOptions::chunk_size, each in its own short transaction.
+/// Afterwards the freed pages are returned to the file system with PRAGMA incremental_vacuum in small steps.
+/// \note Vacuuming requires the database to use ConnectionOptions::auto_vacuum Incremental. The tables need a rowid,
+/// WITHOUT ROWID tables are not supported.
+class RetentionManager {
+private:
+    ConnectionInterface* database;
+    RetentionOptions options;
+    std::vector<RetentionRule> rules;
+
+    /// \brief Deletes the rows of \p rule older than \p now - max_age and beyond max_rows
+    /// \return False if the run was cancelled
+    bool apply_rule(const RetentionRule& rule, std::chrono::system_clock::time_point now, RetentionResult& result);
+
+    /// \brief Deletes the rows with rowids from \p first to \p last that also match \p condition in chunks.
+    /// \p condition is appended to the WHERE clause, \p args are bound to its parameters.
+    /// \return False if the run was cancelled
+    template <typename... Args>
+    bool delete_chunks(const RetentionRule& rule, const std::string& condition, std::int64_t first,
+                       std::int64_t last, RetentionResult& result, const Args&... args);
+
+    /// \brief Returns free pages to the file system with PRAGMA incremental_vacuum
+    /// \return False if the run was cancelled
+    bool vacuum(RetentionResult& result);
+
+    /// \brief Pauses between chunks. Returns false if the run is cancelled.
+    bool yield();
+
+public:
+    /// \note \p database must outlive this object
+    /// \note Throws std::invalid_argument if RetentionOptions::chunk_size is not positive
+    explicit RetentionManager(ConnectionInterface* database, const RetentionOptions& options = {});
+
+    /// \brief Adds \p rule, which is applied by every following run()
+    /// \note Throws std::invalid_argument if the rule has no limit, max_rows is negative or max_age is set without an
+    /// age column
+    void add_rule(const RetentionRule& rule);
+
+    /// \brief Applies all rules, then vacuums the database
+    /// \param now Time the ages are measured from
+    /// \note Throws a QueryExecutionException if a statement fails, chunks deleted before stay deleted
+    RetentionResult run(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+};
+
+} // namespace everest::db::sqlite
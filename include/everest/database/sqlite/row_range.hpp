@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/statement.hpp>
+
+namespace everest::db::sqlite {
+
+namespace detail {
+template <typename T> struct is_optional : std::false_type {};
+template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T> constexpr bool always_false = false;
+
+/// \brief Checks if a value of SQLite type \p type can be decoded into a T
+template <typename T> bool column_type_matches(int type) {
+    if constexpr (is_optional<T>::value) {
+        return type == SQLITE_NULL or column_type_matches<typename T::value_type>(type);
+    } else if constexpr (std::is_same_v<T, int> or std::is_same_v<T, std::int64_t>) {
+        return type == SQLITE_INTEGER;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return type == SQLITE_FLOAT or type == SQLITE_INTEGER;
+    } else if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, std::string_view>) {
+        return type == SQLITE_TEXT;
+    } else if constexpr (std::is_same_v<T, ByteSpan> or std::is_same_v<T, std::vector<std::uint8_t>>) {
+        return type == SQLITE_BLOB;
+    } else {
+        static_assert(always_false<T>, "Unsupported column type for RowRange");
+    }
+}
+
+/// \brief Decodes column \p idx of the current row into a T
+template <typename T> T read_column(StatementInterface& statement, int idx) {
+    if constexpr (is_optional<T>::value) {
+        if (statement.column_type(idx) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        return read_column<typename T::value_type>(statement, idx);
+    } else if constexpr (std::is_same_v<T, int>) {
+        return statement.column_int(idx);
+    } else if constexpr (std::is_same_v<T, std::int64_t>) {
+        return statement.column_int64(idx);
+    } else if constexpr (std::is_same_v<T, double>) {
+        return statement.column_double(idx);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return statement.column_text(idx);
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        return statement.column_text_view(idx);
+    } else if constexpr (std::is_same_v<T, ByteSpan>) {
+        return statement.column_blob(idx);
+    } else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>) {
+        const auto blob = statement.column_blob(idx);
+        return std::vector<std::uint8_t>(blob.begin(), blob.end());
+    } else {
+        static_assert(always_false<T>, "Unsupported column type for RowRange");
+    }
+}
+} // namespace detail
+
+/// \brief Range over the result rows of a statement, decoding the columns of every row into a std::tuple<Columns...>.
+///
+/// Supported column types are int, int64_t, double, std::string, std::string_view, ByteSpan, std::vector<uint8_t> and
+/// std::optional of these for nullable columns. The column count and types are checked once at the first row, a
+/// mismatch throws a QueryExecutionException. Views (std::string_view, ByteSpan) are only valid for the current row.
+///
+/// Iteration ends when step() returns SQLITE_DONE. Any other result than SQLITE_ROW throws a
+/// QueryExecutionException, or a QueryInterruptedException for SQLITE_INTERRUPT, so a partially read result is never
+/// mistaken for a complete one.
+template <typename... Columns> class RowRange {
+public:
+    using value_type = std::tuple<Columns...>;
+
+    class iterator {
+    private:
+        RowRange* range;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = RowRange::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        explicit iterator(RowRange* range) noexcept : range(range) {
+        }
+
+        reference operator*() const {
+            return this->range->current;
+        }
+        pointer operator->() const {
+            return &this->range->current;
+        }
+        iterator& operator++() {
+            if (!this->range->advance()) {
+                this->range = nullptr;
+            }
+            return *this;
+        }
+        bool operator==(const iterator& other) const {
+            return this->range == other.range;
+        }
+        bool operator!=(const iterator& other) const {
+            return this->range != other.range;
+        }
+    };
+
+private:
+    StatementInterface& statement;
+    value_type current;
+    int result;
+    bool checked;
+
+    template <std::size_t... Idx> void check_columns(std::index_sequence<Idx...>) {
+        const auto column_count = this->statement.get_number_of_rows();
+        if (column_count != static_cast<int>(sizeof...(Columns))) {
+            throw QueryExecutionException("Row has " + std::to_string(column_count) + " columns but " +
+                                          std::to_string(sizeof...(Columns)) + " were requested");
+        }
+        const bool matches[] = {
+            detail::column_type_matches<Columns>(this->statement.column_type(static_cast<int>(Idx)))...};
+        for (std::size_t i = 0; i < sizeof...(Columns); i++) {
+            if (!matches[i]) {
+                throw QueryExecutionException("Type of column " + std::to_string(i) +
+                                              " does not match the requested type");
+            }
+        }
+    }
+
+    template <std::size_t... Idx> void decode(std::index_sequence<Idx...>) {
+        this->current = value_type{detail::read_column<Columns>(this->statement, static_cast<int>(Idx))...};
+    }
+
+    bool advance() {
+        this->result = this->statement.step();
+        if (this->result == SQLITE_DONE) {
+            return false;
+        }
+        if (this->result == SQLITE_INTERRUPT) {
+            throw QueryInterruptedException("Query was interrupted while reading rows");
+        }
+        if (this->result != SQLITE_ROW) {
+            throw QueryExecutionException(std::string{"Could not read rows: "} + sqlite3_errstr(this->result));
+        }
+        if (!this->checked) {
+            this->check_columns(std::index_sequence_for<Columns...>{});
+            this->checked = true;
+        }
+        this->decode(std::index_sequence_for<Columns...>{});
+        return true;
+    }
+
+public:
+    explicit RowRange(StatementInterface& statement) :
+        statement(statement), current{}, result(SQLITE_OK), checked(false) {
+    }
+
+    /// \brief Steps to the first row. A range can only be iterated once.
+    iterator begin() {
+        return iterator{this->advance() ? this : nullptr};
+    }
+
+    iterator end() {
+        return iterator{nullptr};
+    }
+
+    /// \brief Result of the last step(): SQLITE_DONE after all rows were read, the error code if iteration threw
+    int status() const {
+        return this->result;
+    }
+};
+
+template <typename... Columns> RowRange<Columns...> StatementInterface::rows() {
+    return RowRange<Columns...>{*this};
+}
+
+} // namespace everest::db::sqlite
@@ -5,23 +5,75 @@
 
 #include <everest/database/sqlite/connection.hpp>
 
+#include <array>
+#include <optional>
+#include <string_view>
+
 namespace everest::db::sqlite {
 
+enum class MigrationDirection {
+    Up,
+    Down
+};
+
+/// \brief Migration compiled into the binary, usually generated by collect_migration_files(EMBED_HEADER ...)
+struct EmbeddedMigration {
+    uint32_t version;
+    MigrationDirection direction;
+    std::string_view name; ///< Name of the migration file, only used for logging
+    std::string_view sql;
+};
+
 class SchemaUpdater {
 private:
     ConnectionInterface* database;
+    std::optional<fs::path> initial_database_image;
+    std::optional<fs::path> backup_file_path;
+    BackupOptions backup_options;
+
+    /// \brief Migrates the database from its user version to \p target_schema_version with the migrations returned by
+    /// \p load_migration_files, which is only called when there is something to migrate
+    template <typename LoadMigrationFiles>
+    bool apply_migrations(uint32_t target_schema_version, LoadMigrationFiles load_migration_files);
 
 public:
     /// \brief Class that can apply migration files to a database to update the schema
     /// \param database Interface for the database connection
     explicit SchemaUpdater(ConnectionInterface* database) noexcept;
 
+    /// \brief Initialize new databases from \p image instead of applying all migrations from version 1. The image is
+    /// a database file at the user version of its last migration, e.g. generated by
+    /// collect_migration_files(INITIAL_DATABASE_IMAGE ...). It is only used when the database is empty and at user
+    /// version 0, existing databases are always migrated. Missing migrations on top of the image are applied as usual,
+    /// if they fail the database is returned to its empty state.
+    void use_initial_database_image(const fs::path& image);
+
+    /// \brief Create a backup of the database at \p backup_file_path with ConnectionInterface::backup_to() before
+    /// migrations are applied to it. The backup is only made for existing databases that actually get migrated. If
+    /// the backup fails or is cancelled, no migration is applied.
+    void backup_before_migration(const fs::path& backup_file_path, const BackupOptions& options = {});
+
     /// \brief Apply migration files to a database to update the schema
     /// \param sql_migration_files_path Filesystem path to migration file folder
     /// \param target_schema_version The target schema version of the database
     /// \return True if migrations applied successfully, false otherwise. Database is not modified when the migration
     /// fails.
     bool apply_migration_files(const fs::path& migration_file_directory, uint32_t target_schema_version);
+
+    /// \brief Apply migrations compiled into the binary to a database to update the schema. Same as
+    /// apply_migration_files() but without any filesystem access or filename parsing.
+    /// \param migrations Pointer to \p count migrations, in any order
+    /// \param count Number of migrations
+    /// \param target_schema_version The target schema version of the database
+    /// \return True if migrations applied successfully, false otherwise. Database is not modified when the migration
+    /// fails.
+    bool apply_embedded_migrations(const EmbeddedMigration* migrations, std::size_t count,
+                                   uint32_t target_schema_version);
+
+    template <std::size_t N>
+    bool apply_embedded_migrations(const std::array<EmbeddedMigration, N>& migrations, uint32_t target_schema_version) {
+        return this->apply_embedded_migrations(migrations.data(), migrations.size(), target_schema_version);
+    }
 };
 
 } // namespace everest::db::sqlite
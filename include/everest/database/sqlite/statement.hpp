@@ -3,9 +3,16 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include <sqlite3.h>
 
@@ -20,6 +27,80 @@ enum class SQLiteString {
 /// @bried Variant type for possible return value based on name getter
 using SqliteVariant = std::variant<std::monostate, int, double, int64_t, std::string>;
 
+/// \brief Non-owning view on a contiguous sequence of bytes, e.g. the value of a BLOB column
+class ByteSpan {
+private:
+    const std::uint8_t* ptr;
+    std::size_t length;
+
+public:
+    constexpr ByteSpan() noexcept : ptr(nullptr), length(0) {
+    }
+    constexpr ByteSpan(const std::uint8_t* data, std::size_t size) noexcept : ptr(data), length(size) {
+    }
+    ByteSpan(const std::vector<std::uint8_t>& bytes) noexcept : ptr(bytes.data()), length(bytes.size()) {
+    }
+
+    constexpr const std::uint8_t* data() const noexcept {
+        return this->ptr;
+    }
+    constexpr std::size_t size() const noexcept {
+        return this->length;
+    }
+    constexpr bool empty() const noexcept {
+        return this->length == 0;
+    }
+    constexpr const std::uint8_t* begin() const noexcept {
+        return this->ptr;
+    }
+    constexpr const std::uint8_t* end() const noexcept {
+        return this->ptr + this->length;
+    }
+    constexpr std::uint8_t operator[](std::size_t idx) const noexcept {
+        return this->ptr[idx];
+    }
+};
+
+/// \brief Counters of a prepared statement from sqlite3_stmt_status, summed over all its executions
+struct StatementStats {
+    std::int64_t fullscan_steps{0}; ///< Forward steps in full table scans, high values hint at a missing index
+    std::int64_t sorts{0};          ///< Sort operations, which an index could avoid
+    std::int64_t autoindexes{0};    ///< Rows inserted into automatic indexes, which hints at a missing index
+    std::int64_t vm_steps{0};       ///< Virtual machine operations, a rough measure of the work done
+    std::int64_t reprepares{0};     ///< Automatic re-prepares after schema changes
+    std::int64_t runs{0};           ///< Completed executions
+    std::int64_t filter_hits{0};    ///< Bloom filter lookups that found a row (0 before SQLite 3.38)
+    std::int64_t filter_misses{0};  ///< Bloom filter lookups that avoided a search (0 before SQLite 3.38)
+    std::int64_t memory_used{0};    ///< Heap bytes used by the prepared statement
+};
+
+template <typename... Columns> class RowRange;
+class StatementInterface;
+
+/// \brief Named parameter of a statement with its index resolved once, so it can be bound repeatedly at the cost of an
+/// index bind. Only valid as long as the statement it was obtained from.
+class ParameterHandle {
+private:
+    StatementInterface* statement;
+    int idx;
+
+public:
+    ParameterHandle(StatementInterface& statement, int idx) noexcept : statement(&statement), idx(idx) {
+    }
+
+    int index() const noexcept {
+        return this->idx;
+    }
+
+    int bind_text(const std::string& val, SQLiteString lifetime = SQLiteString::Static);
+    int bind_int(const int val);
+    int bind_int64(const int64_t val);
+    int bind_double(const double val);
+    int bind_null();
+    int bind_blob(ByteSpan val, SQLiteString lifetime = SQLiteString::Static);
+    int bind_zeroblob(const std::uint64_t size);
+};
+
 /// \brief Interface for Statement wrapper class that handles finalization, step, binding and column access of
 /// sqlite3_stmt
 class StatementInterface {
@@ -30,6 +111,10 @@ public:
     virtual int reset() = 0;
     virtual int changes() = 0;
 
+    /// \brief Returns the runtime counters of this statement, resetting them after reading if \p reset is set. The
+    /// default implementation returns all counters as zero.
+    virtual StatementStats stats(bool reset = false);
+
     virtual int bind_text(const int idx, const std::string& val, SQLiteString lifetime = SQLiteString::Static) = 0;
     virtual int bind_text(const std::string& param, const std::string& val,
                           SQLiteString lifetime = SQLiteString::Static) = 0;
@@ -41,30 +126,130 @@ public:
     virtual int bind_double(const std::string& param, const double val) = 0;
     virtual int bind_null(const int idx) = 0;
     virtual int bind_null(const std::string& param) = 0;
+    /// \note The default implementations of the BLOB bindings bind nothing and return SQLITE_MISUSE
+    virtual int bind_blob(const int idx, ByteSpan val, SQLiteString lifetime = SQLiteString::Static);
+    virtual int bind_blob(const std::string& param, ByteSpan val, SQLiteString lifetime = SQLiteString::Static);
+    /// \brief Binds a BLOB of \p size zero bytes, e.g. to reserve space that is filled later with a BlobStream
+    virtual int bind_zeroblob(const int idx, const std::uint64_t size);
+    virtual int bind_zeroblob(const std::string& param, const std::uint64_t size);
+
+    /// \brief Returns the index of the parameter named \p name (including its prefix, e.g. ":id"), 0 if there is none
+    /// \note The default implementation always returns 0
+    virtual int parameter_index(std::string_view name);
+
+    /// \brief Returns a handle that binds the parameter named \p name by its index
+    /// \note Will throw a std::out_of_range if the parameter does not exist
+    ParameterHandle param(std::string_view name) {
+        const auto idx = this->parameter_index(name);
+        if (idx <= 0) {
+            throw std::out_of_range("Parameter not found in SQL query");
+        }
+        return ParameterHandle{*this, idx};
+    }
 
     virtual int get_number_of_rows() = 0;
+
+    /// \brief Returns the index of the result column named \p name, -1 if there is none. For duplicate names the first
+    /// column is returned.
+    /// \note The default implementation always returns -1
+    virtual int column_index(std::string_view name);
+
     virtual int column_type(const int idx) = 0;
     virtual SqliteVariant column_variant(const std::string& name) = 0;
     virtual std::string column_text(const int idx) = 0;
     virtual std::optional<std::string> column_text_nullable(const int idx) = 0;
+
+    /// \brief Returns the text of column \p idx without copying it, empty for NULL.
+    /// \note The view is only valid until the next step() or reset() of this statement. The default implementation
+    /// throws a QueryExecutionException since it has no storage the view could refer to.
+    virtual std::string_view column_text_view(const int idx);
+
+    /// \brief Copies the text of column \p idx into \p out, reusing its allocated capacity.
+    /// \return False if the column is NULL, \p out is cleared in that case
+    /// \note The default implementation copies the value of column_text_nullable()
+    virtual bool column_text_into(const int idx, std::string& out);
+
+    /// \brief Returns the bytes of column \p idx without copying them, empty for NULL.
+    /// \note The span is only valid until the next step() or reset() of this statement. The default implementation
+    /// throws a QueryExecutionException.
+    virtual ByteSpan column_blob(const int idx);
+
+    /// \brief Returns a copy of the bytes of the column named \p name
+    /// \return nothing if there is no such column or its value is NULL
+    /// \note column_variant() keeps returning BLOB columns as std::string
+    std::optional<std::vector<std::uint8_t>> column_blob_copy(std::string_view name) {
+        const auto idx = this->column_index(name);
+        if (idx < 0 or this->column_type(idx) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        const auto blob = this->column_blob(idx);
+        return std::vector<std::uint8_t>(blob.begin(), blob.end());
+    }
+
     virtual int column_int(const int idx) = 0;
     virtual int64_t column_int64(const int idx) = 0;
     virtual double column_double(const int idx) = 0;
+
+    /// \brief Returns a range that steps through the result rows and decodes each into a std::tuple<Columns...>, e.g.
+    /// `for (const auto& [id, name] : stmt->rows<int64_t, std::string_view>())`. See RowRange for details.
+    template <typename... Columns> RowRange<Columns...> rows();
 };
 
+inline int ParameterHandle::bind_text(const std::string& val, SQLiteString lifetime) {
+    return this->statement->bind_text(this->idx, val, lifetime);
+}
+inline int ParameterHandle::bind_int(const int val) {
+    return this->statement->bind_int(this->idx, val);
+}
+inline int ParameterHandle::bind_int64(const int64_t val) {
+    return this->statement->bind_int64(this->idx, val);
+}
+inline int ParameterHandle::bind_double(const double val) {
+    return this->statement->bind_double(this->idx, val);
+}
+inline int ParameterHandle::bind_null() {
+    return this->statement->bind_null(this->idx);
+}
+inline int ParameterHandle::bind_blob(ByteSpan val, SQLiteString lifetime) {
+    return this->statement->bind_blob(this->idx, val, lifetime);
+}
+inline int ParameterHandle::bind_zeroblob(const std::uint64_t size) {
+    return this->statement->bind_zeroblob(this->idx, size);
+}
+
+class QueryLimiter;
+
 /// \brief RAII wrapper class that handles finalization, step, binding and column access of sqlite3_stmt
 class Statement : public StatementInterface {
 private:
     sqlite3_stmt* stmt;
     sqlite3* db;
+    QueryLimiter* limiter; ///< Bounds every execution by its statement timeout if set
+    std::optional<std::chrono::steady_clock::time_point> execution_deadline;
+    /// \brief Name to index lookup tables sorted by name, built once after preparing
+    std::vector<std::pair<std::string, int>> parameter_indices;
+    std::vector<std::pair<std::string, int>> column_indices;
+    int column_indices_reprepare_count; ///< SQLITE_STMTSTATUS_REPREPARE when column_indices was built
+
+    void build_column_indices();
+    int resolve_parameter(const std::string& param);
 
 public:
     Statement(sqlite3* db, const std::string& query);
+    /// \brief Prepares \p query with additional \p prepare_flags (SQLITE_PREPARE_*) passed to sqlite3_prepare_v3
+    Statement(sqlite3* db, const std::string& query, unsigned int prepare_flags);
     ~Statement() override;
 
+    /// \brief Resets all bound parameters to NULL
+    int clear_bindings();
+
+    /// \brief Bounds every following execution by the statement timeout of \p limiter, counted from its first step()
+    void set_query_limiter(QueryLimiter* limiter);
+
     int step() override;
     int reset() override;
     int changes() override;
+    StatementStats stats(bool reset = false) override;
 
     int bind_text(const int idx, const std::string& val, SQLiteString lifetime = SQLiteString::Static) override;
     int bind_text(const std::string& param, const std::string& val,
@@ -77,15 +262,26 @@ public:
     int bind_int64(const std::string& param, const int64_t val) override;
     int bind_null(const int idx) override;
     int bind_null(const std::string& param) override;
+    int bind_blob(const int idx, ByteSpan val, SQLiteString lifetime = SQLiteString::Static) override;
+    int bind_blob(const std::string& param, ByteSpan val, SQLiteString lifetime = SQLiteString::Static) override;
+    int bind_zeroblob(const int idx, const std::uint64_t size) override;
+    int bind_zeroblob(const std::string& param, const std::uint64_t size) override;
+    int parameter_index(std::string_view name) override;
 
     int get_number_of_rows() override;
+    int column_index(std::string_view name) override;
     int column_type(const int idx) override;
     SqliteVariant column_variant(const std::string& name) override;
     std::string column_text(const int idx) override;
     std::optional<std::string> column_text_nullable(const int idx) override;
+    std::string_view column_text_view(const int idx) override;
+    bool column_text_into(const int idx, std::string& out) override;
+    ByteSpan column_blob(const int idx) override;
     int column_int(const int idx) override;
     int64_t column_int64(const int idx) override;
     double column_double(const int idx) override;
 };
 
 } // namespace everest::db::sqlite
+
+#include <everest/database/sqlite/row_range.hpp>
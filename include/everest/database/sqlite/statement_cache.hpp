@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <everest/database/sqlite/statement.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Default number of prepared statements kept per connection
+constexpr std::size_t DEFAULT_STATEMENT_CACHE_CAPACITY = 32;
+
+/// \brief Counters describing the usage of a StatementCache
+struct StatementCacheStats {
+    std::uint64_t hits{0};      ///< Number of acquires served from the cache
+    std::uint64_t misses{0};    ///< Number of acquires that had to prepare a new statement
+    std::uint64_t evictions{0}; ///< Number of statements finalized because the cache was full
+    std::size_t size{0};        ///< Number of idle statements currently cached
+    std::size_t capacity{0};    ///< Maximum number of idle statements kept
+};
+
+/// \brief Bounded LRU cache of prepared statements keyed by their SQL text.
+///
+/// Statements are handed out as exclusive handles. When a handle is destroyed the statement is reset, its bindings
+/// are cleared and it is put back into the cache so the next acquire of the same SQL skips parsing and planning.
+/// If the statement for a SQL text is already handed out, a second uncached statement is prepared instead.
+class StatementCache {
+private:
+    class CachedStatement;
+    using Entry = std::pair<std::string, std::unique_ptr<Statement>>;
+
+    mutable std::mutex mutex;
+    std::size_t capacity;
+    std::uint64_t generation;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    StatementCacheStats stats;
+
+    void release(std::uint64_t statement_generation, std::string sql, std::unique_ptr<Statement> statement);
+
+public:
+    /// \brief Creates a cache holding at most \p capacity idle statements. A capacity of 0 disables caching.
+    explicit StatementCache(std::size_t capacity = DEFAULT_STATEMENT_CACHE_CAPACITY) noexcept;
+    ~StatementCache();
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /// \brief Returns a statement for \p sql on \p db, reusing a cached one if available. Executions of the statement
+    /// are bounded by the statement timeout of \p limiter if it is set, see Statement::set_query_limiter.
+    /// \note Will throw a QueryExecutionException if the statement can't be prepared
+    /// \note The returned handle must not outlive the database connection it was acquired for
+    std::unique_ptr<StatementInterface> acquire(sqlite3* db, const std::string& sql, QueryLimiter* limiter = nullptr);
+
+    /// \brief Finalizes all idle statements. Handles that are still in use are not returned to the cache anymore.
+    void clear();
+
+    /// \brief Changes the capacity of the cache, evicting the least recently used statements if needed
+    void set_capacity(std::size_t capacity);
+
+    /// \brief Returns a snapshot of the cache counters
+    StatementCacheStats get_stats() const;
+};
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+
+#include <everest/database/sqlite/async_connection.hpp>
+
+namespace everest::db::sqlite {
+
+AsyncConnection::Executor::Executor(std::size_t thread_count) : running(true) {
+    for (std::size_t i = 0; i < thread_count; i++) {
+        this->threads.emplace_back(&Executor::run, this);
+    }
+}
+
+AsyncConnection::Executor::~Executor() {
+    {
+        const std::lock_guard lock(this->queue_mutex);
+        this->running = false;
+    }
+    this->queue_changed.notify_all();
+    for (auto& thread : this->threads) {
+        thread.join();
+    }
+}
+
+void AsyncConnection::Executor::push(std::function<void()> task) {
+    {
+        const std::lock_guard lock(this->queue_mutex);
+        this->queue.push_back({std::move(task), std::chrono::steady_clock::now()});
+        this->stats.queue_depth = this->queue.size();
+        this->stats.max_queue_depth = std::max(this->stats.max_queue_depth, this->stats.queue_depth);
+    }
+    this->queue_changed.notify_one();
+}
+
+AsyncConnectionStats AsyncConnection::Executor::get_stats() const {
+    const std::lock_guard lock(this->queue_mutex);
+    return this->stats;
+}
+
+void AsyncConnection::Executor::run() {
+    std::unique_lock lock(this->queue_mutex);
+    while (true) {
+        this->queue_changed.wait(lock, [this]() { return !this->queue.empty() or !this->running; });
+        if (this->queue.empty()) {
+            // Stopped and everything queued is done
+            return;
+        }
+        auto task = std::move(this->queue.front());
+        this->queue.pop_front();
+        const auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                     task.submitted);
+        this->stats.queue_depth = this->queue.size();
+        this->stats.total_wait_time += wait_time;
+        this->stats.max_wait_time = std::max(this->stats.max_wait_time, wait_time);
+        lock.unlock();
+
+        // Exceptions are stored in the future of the task
+        task.run();
+
+        lock.lock();
+        this->stats.tasks_completed++;
+    }
+}
+
+AsyncConnection::AsyncConnection(ConnectionInterface* database) : database(database), pool(nullptr), writer(1) {
+}
+
+AsyncConnection::AsyncConnection(ConnectionPool* pool, std::size_t reader_threads) :
+    database(pool),
+    pool(pool),
+    readers(reader_threads > 0 ? std::make_unique<Executor>(reader_threads) : nullptr),
+    writer(1) {
+}
+
+AsyncConnectionStats AsyncConnection::get_stats() const {
+    return this->writer.get_stats();
+}
+
+AsyncConnectionStats AsyncConnection::get_reader_stats() const {
+    if (this->readers == nullptr) {
+        return {};
+    }
+    return this->readers->get_stats();
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <cctype>
+
+#include <everest/database/sqlite/batch_writer.hpp>
+
+using namespace std::string_literals;
+
+namespace everest::db::sqlite {
+
+double BatchResult::rows_per_second() const {
+    const auto seconds = std::chrono::duration<double>(this->elapsed).count();
+    if (seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(this->rows) / seconds;
+}
+
+namespace detail {
+std::string expand_values_clause(const std::string& sql, std::size_t columns, std::size_t rows) {
+    std::string upper{sql};
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    // Find the VALUES keyword, not identifiers containing it like "meter_values"
+    const auto is_identifier = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) or c == '_'; };
+    auto values = upper.find("VALUES");
+    while (values != std::string::npos and
+           ((values > 0 and is_identifier(upper[values - 1])) or
+            (values + 6 < upper.size() and is_identifier(upper[values + 6])))) {
+        values = upper.find("VALUES", values + 6);
+    }
+    const auto open = values == std::string::npos ? std::string::npos : sql.find('(', values);
+    if (open == std::string::npos) {
+        throw QueryExecutionException("No VALUES clause to expand in: "s + sql);
+    }
+
+    std::size_t depth = 0;
+    std::size_t close = open;
+    for (; close < sql.size(); close++) {
+        if (sql[close] == '(') {
+            depth++;
+        } else if (sql[close] == ')' and --depth == 0) {
+            break;
+        }
+    }
+    if (close == sql.size()) {
+        throw QueryExecutionException("Unbalanced VALUES clause in: "s + sql);
+    }
+
+    const auto group = sql.substr(open, close - open + 1);
+    if (static_cast<std::size_t>(std::count(group.begin(), group.end(), '?')) != columns) {
+        throw QueryExecutionException("VALUES clause needs exactly "s + std::to_string(columns) +
+                                      " anonymous placeholders to be expanded: " + sql);
+    }
+
+    std::string result = sql.substr(0, open);
+    result.reserve(sql.size() + (group.size() + 1) * rows);
+    for (std::size_t i = 0; i < rows; i++) {
+        if (i > 0) {
+            result += ',';
+        }
+        result += group;
+    }
+    result += sql.substr(close + 1);
+    return result;
+}
+} // namespace detail
+
+} // namespace everest::db::sqlite
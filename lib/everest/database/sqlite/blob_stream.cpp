@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/blob_stream.hpp>
+#include <everest/database/sqlite/helpers.hpp>
+#include <everest/logging.hpp>
+
+using namespace std::string_literals;
+
+namespace everest::db::sqlite {
+
+namespace {
+void check_range(std::size_t offset, std::size_t length, std::size_t size) {
+    if (offset > size or length > size - offset) {
+        throw QueryExecutionException("BLOB access out of range: offset "s + std::to_string(offset) + ", length " +
+                                      std::to_string(length) + ", size " + std::to_string(size));
+    }
+}
+} // namespace
+
+BlobStream::BlobStream(sqlite3* db, const std::string& table, const std::string& column, std::int64_t rowid,
+                       bool writable) :
+    blob(nullptr), db(db) {
+    if (sqlite3_blob_open(db, "main", table.c_str(), column.c_str(), rowid, writable ? 1 : 0, &this->blob) !=
+        SQLITE_OK) {
+        EVLOG_error << sqlite3_errmsg(db);
+        throw QueryExecutionException("Could not open BLOB for "s + table + "." + column);
+    }
+}
+
+BlobStream::~BlobStream() {
+    if (this->blob != nullptr) {
+        if (sqlite3_blob_close(this->blob) != SQLITE_OK) {
+            EVLOG_error << "Error closing BLOB: " << sqlite3_errmsg(this->db);
+        }
+    }
+}
+
+std::size_t BlobStream::size() {
+    return static_cast<std::size_t>(sqlite3_blob_bytes(this->blob));
+}
+
+void BlobStream::read(std::size_t offset, std::uint8_t* buffer, std::size_t length) {
+    check_range(offset, length, this->size());
+    if (sqlite3_blob_read(this->blob, buffer, clamp_to<int>(length), clamp_to<int>(offset)) != SQLITE_OK) {
+        throw QueryExecutionException("Could not read BLOB: "s + sqlite3_errmsg(this->db));
+    }
+}
+
+std::vector<std::uint8_t> BlobStream::read(std::size_t offset, std::size_t length) {
+    std::vector<std::uint8_t> result(length);
+    this->read(offset, result.data(), length);
+    return result;
+}
+
+void BlobStream::write(std::size_t offset, ByteSpan data) {
+    check_range(offset, data.size(), this->size());
+    if (sqlite3_blob_write(this->blob, data.data(), clamp_to<int>(data.size()), clamp_to<int>(offset)) !=
+        SQLITE_OK) {
+        throw QueryExecutionException("Could not write BLOB: "s + sqlite3_errmsg(this->db));
+    }
+}
+
+void BlobStream::reopen(std::int64_t rowid) {
+    if (sqlite3_blob_reopen(this->blob, rowid) != SQLITE_OK) {
+        throw QueryExecutionException("Could not move BLOB to row "s + std::to_string(rowid) + ": " +
+                                      sqlite3_errmsg(this->db));
+    }
+}
+
+} // namespace everest::db::sqlite
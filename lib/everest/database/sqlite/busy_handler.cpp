@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <everest/database/sqlite/busy_handler.hpp>
+#include <everest/logging.hpp>
+
+using std::chrono::duration_cast;
+
+namespace everest::db::sqlite {
+
+BusyHandler::BusyHandler(const BusyRetryOptions& options) : options(options), random(std::random_device{}()) {
+}
+
+void BusyHandler::attach(sqlite3* db) {
+    sqlite3_busy_handler(db, &BusyHandler::callback, this);
+}
+
+BusyStats BusyHandler::get_stats() const {
+    const std::lock_guard lock(this->stats_mutex);
+    return this->stats;
+}
+
+int BusyHandler::callback(void* context, int count) {
+    return static_cast<BusyHandler*>(context)->retry(count) ? 1 : 0;
+}
+
+bool BusyHandler::retry(int count) {
+    // SQLite holds the connection mutex while calling the handler, so there is one busy event per connection at a time
+    const auto now = std::chrono::steady_clock::now();
+    std::chrono::microseconds delay{0};
+    {
+        const std::lock_guard lock(this->stats_mutex);
+        if (count == 0) {
+            this->event_start = now;
+            this->stats.busy_events++;
+        }
+        const auto waited = duration_cast<std::chrono::microseconds>(now - this->event_start);
+        this->stats.max_wait_time = std::max(this->stats.max_wait_time, waited);
+        if (waited >= this->options.timeout) {
+            this->stats.timeouts++;
+            EVLOG_warning << "Database is still locked after " << waited.count() / 1000 << "ms, giving up";
+            return false;
+        }
+
+        const double backoff = this->options.initial_delay.count() * std::pow(this->options.multiplier, count);
+        const double limited = std::min(backoff, static_cast<double>(this->options.max_delay.count()));
+        std::uniform_real_distribution<double> jitter(1.0 - std::clamp(this->options.jitter, 0.0, 1.0), 1.0);
+        delay = std::chrono::microseconds(static_cast<std::int64_t>(limited * 1000 * jitter(this->random)));
+        // Don't sleep past the timeout
+        delay = std::min(delay, duration_cast<std::chrono::microseconds>(this->options.timeout) - waited);
+        this->stats.retries++;
+        this->stats.total_wait_time += delay;
+    }
+    std::this_thread::sleep_for(delay);
+    return true;
+}
+
+} // namespace everest::db::sqlite
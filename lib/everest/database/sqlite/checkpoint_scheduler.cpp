@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <cstring>
+
+#include <everest/database/sqlite/checkpoint_scheduler.hpp>
+#include <everest/database/sqlite/statement.hpp>
+#include <everest/logging.hpp>
+
+namespace everest::db::sqlite {
+
+namespace {
+// Each WAL frame is a page plus a frame header
+constexpr std::uint64_t WAL_FRAME_HEADER_SIZE = 24;
+
+int to_sqlite(CheckpointMode mode) {
+    switch (mode) {
+    case CheckpointMode::Full:
+        return SQLITE_CHECKPOINT_FULL;
+    case CheckpointMode::Restart:
+        return SQLITE_CHECKPOINT_RESTART;
+    case CheckpointMode::Truncate:
+        return SQLITE_CHECKPOINT_TRUNCATE;
+    case CheckpointMode::Passive:
+    default:
+        return SQLITE_CHECKPOINT_PASSIVE;
+    }
+}
+
+std::string query_text(sqlite3* db, const std::string& sql) {
+    Statement statement{db, sql};
+    return statement.step() == SQLITE_ROW ? statement.column_text(0) : std::string{};
+}
+} // namespace
+
+CheckpointScheduler::CheckpointScheduler(const CheckpointOptions& options) :
+    options(options),
+    database(nullptr),
+    checkpoint(nullptr),
+    frame_size(0),
+    running(false),
+    checkpointed_frames(0) {
+}
+
+CheckpointScheduler::~CheckpointScheduler() {
+    this->detach();
+}
+
+bool CheckpointScheduler::attach(sqlite3* db) {
+    if (this->database != nullptr) {
+        EVLOG_error << "Checkpoint scheduler is already attached";
+        return false;
+    }
+
+    const char* file_name = sqlite3_db_filename(db, "main");
+    if (file_name == nullptr or std::strlen(file_name) == 0) {
+        EVLOG_error << "Background checkpoints need a database file";
+        return false;
+    }
+    try {
+        if (query_text(db, "PRAGMA journal_mode") != "wal") {
+            EVLOG_error << "Background checkpoints need the database " << file_name << " to be in WAL mode";
+            return false;
+        }
+        this->frame_size = std::stoull(query_text(db, "PRAGMA page_size")) + WAL_FRAME_HEADER_SIZE;
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not read the journal mode of " << file_name << ": " << e.what();
+        return false;
+    }
+
+    // Only the background thread uses this connection. It has to read once to open the WAL, checkpoints on a
+    // connection that never read do nothing.
+    const int open_result =
+        sqlite3_open_v2(file_name, &this->checkpoint, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, nullptr);
+    if (open_result != SQLITE_OK or
+        sqlite3_exec(this->checkpoint, "SELECT COUNT(*) FROM sqlite_master", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        EVLOG_error << "Could not open checkpoint connection to " << file_name << ": "
+                    << sqlite3_errmsg(this->checkpoint);
+        sqlite3_close_v2(this->checkpoint);
+        this->checkpoint = nullptr;
+        return false;
+    }
+    sqlite3_busy_timeout(this->checkpoint, static_cast<int>(this->options.escalation_timeout.count()));
+
+    {
+        const std::lock_guard lock(this->state_mutex);
+        this->running = true;
+        this->last_commit = std::chrono::steady_clock::now();
+        this->retry_at = this->last_commit;
+        this->checkpointed_frames = 0;
+        this->stats.wal_frames = 0;
+        this->stats.frames_pending = 0;
+    }
+    this->database = db;
+    // Registering a WAL hook replaces the automatic checkpoint
+    sqlite3_wal_hook(db, wal_hook, this);
+    this->worker = std::thread(&CheckpointScheduler::run, this);
+    return true;
+}
+
+void CheckpointScheduler::detach() {
+    if (this->database == nullptr) {
+        return;
+    }
+    {
+        const std::lock_guard lock(this->state_mutex);
+        this->running = false;
+    }
+    this->state_changed.notify_all();
+    this->worker.join();
+
+    sqlite3_wal_hook(this->database, nullptr, nullptr);
+    sqlite3_close_v2(this->checkpoint);
+    this->checkpoint = nullptr;
+    this->database = nullptr;
+}
+
+CheckpointStats CheckpointScheduler::get_stats() const {
+    const std::lock_guard lock(this->state_mutex);
+    return this->stats;
+}
+
+int CheckpointScheduler::wal_hook(void* context, sqlite3* /*db*/, const char* schema, int frames) {
+    if (std::strcmp(schema, "main") == 0) {
+        static_cast<CheckpointScheduler*>(context)->on_commit(frames);
+    }
+    return SQLITE_OK;
+}
+
+void CheckpointScheduler::on_commit(int frames) {
+    {
+        const std::lock_guard lock(this->state_mutex);
+        if (frames < this->stats.wal_frames) {
+            // The writer started over at the beginning of the WAL
+            this->checkpointed_frames = 0;
+        }
+        this->stats.wal_frames = frames;
+        this->stats.frames_pending = std::max(frames - this->checkpointed_frames, 0);
+        this->last_commit = std::chrono::steady_clock::now();
+    }
+    this->state_changed.notify_all();
+}
+
+void CheckpointScheduler::run() {
+    std::unique_lock lock(this->state_mutex);
+    while (this->running) {
+        if (this->stats.frames_pending == 0) {
+            this->state_changed.wait(lock);
+            continue;
+        }
+
+        const bool limit_reached =
+            static_cast<std::uint64_t>(this->stats.wal_frames) * this->frame_size >= this->options.wal_size_limit;
+        const auto idle_since = this->last_commit + this->options.idle_time;
+        const auto due = limit_reached ? this->retry_at : std::max(this->retry_at, idle_since);
+        if (std::chrono::steady_clock::now() < due) {
+            this->state_changed.wait_until(lock, due);
+            continue;
+        }
+
+        lock.unlock();
+        this->run_checkpoint(limit_reached ? this->options.escalation_mode : CheckpointMode::Passive);
+        lock.lock();
+    }
+}
+
+void CheckpointScheduler::run_checkpoint(CheckpointMode mode) {
+    int log_frames = -1;
+    int checkpointed = -1;
+    const auto start = std::chrono::steady_clock::now();
+    const int result =
+        sqlite3_wal_checkpoint_v2(this->checkpoint, nullptr, to_sqlite(mode), &log_frames, &checkpointed);
+    const auto end = std::chrono::steady_clock::now();
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    const std::lock_guard lock(this->state_mutex);
+    if (mode == CheckpointMode::Passive) {
+        this->stats.passive_checkpoints++;
+    } else {
+        this->stats.escalated_checkpoints++;
+    }
+    this->stats.last_duration = duration;
+    this->stats.max_duration = std::max(this->stats.max_duration, duration);
+    this->stats.total_duration += duration;
+
+    if (result == SQLITE_OK and (mode == CheckpointMode::Restart or mode == CheckpointMode::Truncate)) {
+        // The next commit starts over at the beginning of the WAL
+        this->checkpointed_frames = 0;
+        this->stats.wal_frames = 0;
+        this->stats.frames_pending = 0;
+    } else if (result == SQLITE_OK or result == SQLITE_BUSY) {
+        // Readers can keep a checkpoint from copying all frames
+        if (checkpointed >= 0) {
+            this->checkpointed_frames = checkpointed;
+            this->stats.wal_frames = std::max(this->stats.wal_frames, log_frames);
+            this->stats.frames_pending = std::max(this->stats.wal_frames - checkpointed, 0);
+        }
+        if (result == SQLITE_BUSY) {
+            this->stats.busy_checkpoints++;
+            EVLOG_warning << "WAL checkpoint could not complete, " << this->stats.frames_pending
+                          << " frames are pending";
+        }
+    } else {
+        EVLOG_error << "WAL checkpoint failed: " << sqlite3_errmsg(this->checkpoint);
+    }
+
+    // Frames that could not be copied are tried again after the idle time instead of immediately
+    this->retry_at = this->stats.frames_pending > 0 ? end + this->options.idle_time : end;
+}
+
+} // namespace everest::db::sqlite
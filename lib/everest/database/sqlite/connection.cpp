@@ -2,9 +2,11 @@
 // Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
 
 #include <chrono>
+#include <thread>
 
 #include <everest/database/exceptions.hpp>
 #include <everest/database/sqlite/connection.hpp>
+#include <everest/database/sqlite/helpers.hpp>
 #include <everest/logging.hpp>
 
 using namespace std::chrono_literals;
@@ -12,15 +14,76 @@ using namespace std::string_literals;
 
 namespace everest::db::sqlite {
 
+namespace {
+const char* begin_statement(TransactionMode mode) {
+    switch (mode) {
+    case TransactionMode::Immediate:
+        return "BEGIN IMMEDIATE TRANSACTION";
+    case TransactionMode::Exclusive:
+        return "BEGIN EXCLUSIVE TRANSACTION";
+    case TransactionMode::Deferred:
+        break;
+    }
+    return "BEGIN TRANSACTION";
+}
+} // namespace
+
+std::unique_ptr<TransactionInterface> ConnectionInterface::begin_transaction(const TransactionOptions& options) {
+    if (options.priority != TransactionPriority::Normal or options.timeout.has_value() or
+        options.mode != TransactionMode::Deferred) {
+        throw QueryExecutionException("Transaction options are not supported by this connection");
+    }
+    return this->begin_transaction();
+}
+
+std::unique_ptr<BlobStreamInterface> ConnectionInterface::open_blob(const std::string& /*table*/,
+                                                                    const std::string& /*column*/, int64_t /*rowid*/,
+                                                                    bool /*writable*/) {
+    throw QueryExecutionException("Incremental BLOB I/O is not supported by this connection");
+}
+
+TruncateResult ConnectionInterface::truncate_tables(const std::vector<std::string>& /*tables*/,
+                                                    const TruncateOptions& /*options*/) {
+    throw QueryExecutionException("Truncating tables is not supported by this connection");
+}
+
+ConnectionStats ConnectionInterface::stats(bool /*reset*/) {
+    return {};
+}
+
+bool ConnectionInterface::restore_from(const fs::path& /*source_file_path*/) {
+    EVLOG_error << "Restoring is not supported by this connection";
+    return false;
+}
+
+std::future<bool> ConnectionInterface::backup_to(const fs::path& /*destination_file_path*/,
+                                                 const BackupOptions& /*options*/) {
+    std::promise<bool> result;
+    result.set_exception(std::make_exception_ptr(BackupException("Backups are not supported by this connection")));
+    return result.get_future();
+}
+
 class DatabaseTransaction : public TransactionInterface {
 private:
     Connection& database;
-    std::unique_lock<std::timed_mutex> mutex;
+    std::unique_lock<PriorityTimedMutex> mutex;
+
+    /// \brief Hands the transaction lock to the next transaction
+    void release() {
+        this->database.transaction_owner = std::thread::id{};
+        this->mutex.unlock();
+    }
 
 public:
-    DatabaseTransaction(Connection& database, std::unique_lock<std::timed_mutex> mutex) :
+    DatabaseTransaction(Connection& database, std::unique_lock<PriorityTimedMutex> mutex, TransactionMode mode) :
         database{database}, mutex{std::move(mutex)} {
-        this->database.execute_statement("BEGIN TRANSACTION");
+        if (this->database.execute_sql(begin_statement(mode)) != SQLITE_OK) {
+            this->release();
+            throw QueryExecutionException(std::string{"Could not begin transaction: "} +
+                                          this->database.get_error_message());
+        }
+        this->database.transaction_owner = std::this_thread::get_id();
+        this->database.savepoint_depth = 0;
     }
 
     // Will by default rollback the transaction if destructed
@@ -31,26 +94,219 @@ public:
     }
 
     void commit() override {
-        const auto retval = this->database.execute_statement("COMMIT TRANSACTION");
-        this->mutex.unlock();
+        const auto retval = this->database.execute_sql("COMMIT TRANSACTION") == SQLITE_OK;
+        this->release();
         if (not retval) {
             throw QueryExecutionException(this->database.get_error_message());
         }
     }
     void rollback() override {
-        const auto retval = this->database.execute_statement("ROLLBACK TRANSACTION");
-        this->mutex.unlock();
+        // SQLite already rolled back if a write of the transaction was interrupted
+        const auto retval = sqlite3_get_autocommit(this->database.db) != 0 or
+                            this->database.execute_sql("ROLLBACK TRANSACTION") == SQLITE_OK;
+        this->release();
         if (not retval) {
             throw QueryExecutionException(this->database.get_error_message());
         }
     }
 };
 
+/// \brief Nested transaction of the thread holding a DatabaseTransaction, mapped to a SAVEPOINT
+class SavepointTransaction : public TransactionInterface {
+private:
+    Connection& database;
+    const std::string name;
+    bool active;
+
+public:
+    explicit SavepointTransaction(Connection& database) :
+        database{database}, name{"nested_" + std::to_string(++database.savepoint_depth)}, active{false} {
+        if (this->database.execute_sql("SAVEPOINT " + this->name) != SQLITE_OK) {
+            this->database.savepoint_depth--;
+            throw QueryExecutionException(std::string{"Could not begin nested transaction: "} +
+                                          this->database.get_error_message());
+        }
+        this->active = true;
+    }
+
+    ~SavepointTransaction() override {
+        if (this->active) {
+            this->rollback();
+        }
+    }
+
+    void commit() override {
+        this->active = false;
+        this->database.savepoint_depth--;
+        if (this->database.execute_sql("RELEASE SAVEPOINT " + this->name) != SQLITE_OK) {
+            throw QueryExecutionException(this->database.get_error_message());
+        }
+    }
+    void rollback() override {
+        this->active = false;
+        this->database.savepoint_depth--;
+        // The savepoint is gone if SQLite rolled back the whole transaction after an interrupted write
+        if (sqlite3_get_autocommit(this->database.db) != 0) {
+            return;
+        }
+        if (this->database.execute_sql("ROLLBACK TRANSACTION TO SAVEPOINT " + this->name) != SQLITE_OK or
+            this->database.execute_sql("RELEASE SAVEPOINT " + this->name) != SQLITE_OK) {
+            throw QueryExecutionException(this->database.get_error_message());
+        }
+    }
+};
+
+namespace {
+/// \brief Copies \p source into a new database file at \p destination_file_path with the online backup API. The copy
+/// is written to "<destination>.partial" first and renamed once it is complete. \p after_step is called with the
+/// progress after every step and cancels the copy by returning false.
+/// \return False if the copy was cancelled, throws a BackupException if it failed
+bool copy_to_file(sqlite3* source, const fs::path& destination_file_path, int pages_per_step,
+                  std::chrono::milliseconds pause, const std::function<bool(const BackupProgress&)>& after_step) {
+    const fs::path partial_file_path = destination_file_path.string() + ".partial";
+    std::error_code error;
+    if (destination_file_path.has_parent_path()) {
+        fs::create_directories(destination_file_path.parent_path(), error);
+    }
+    fs::remove(partial_file_path, error);
+
+    sqlite3* destination = nullptr;
+    if (sqlite3_open_v2(partial_file_path.c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                        nullptr) != SQLITE_OK) {
+        const std::string message = sqlite3_errmsg(destination);
+        sqlite3_close_v2(destination);
+        throw BackupException("Could not create backup file " + partial_file_path.string() + ": " + message);
+    }
+
+    sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+    if (backup == nullptr) {
+        const std::string message = sqlite3_errmsg(destination);
+        sqlite3_close_v2(destination);
+        fs::remove(partial_file_path, error);
+        throw BackupException("Could not start backup: " + message);
+    }
+
+    int result = SQLITE_OK;
+    bool cancelled = false;
+    while (true) {
+        result = sqlite3_backup_step(backup, pages_per_step > 0 ? pages_per_step : -1);
+        // Busy and locked only mean that another connection is writing, retry after the pause
+        const bool finished = result != SQLITE_OK and result != SQLITE_BUSY and result != SQLITE_LOCKED;
+        const BackupProgress progress{sqlite3_backup_pagecount(backup), sqlite3_backup_remaining(backup)};
+        const bool keep_going = !after_step or after_step(progress);
+        if (finished) {
+            break;
+        }
+        if (!keep_going) {
+            cancelled = true;
+            break;
+        }
+        std::this_thread::sleep_for(pause);
+    }
+    sqlite3_backup_finish(backup);
+    sqlite3_close_v2(destination);
+
+    if (cancelled or result != SQLITE_DONE) {
+        fs::remove(partial_file_path, error);
+        if (cancelled) {
+            return false;
+        }
+        throw BackupException("Backup to " + destination_file_path.string() + " failed: " + sqlite3_errstr(result));
+    }
+
+    // WAL files left over from an older database would otherwise be applied to the new one
+    fs::remove(destination_file_path.string() + "-wal", error);
+    fs::remove(destination_file_path.string() + "-shm", error);
+    fs::rename(partial_file_path, destination_file_path, error);
+    if (error) {
+        const auto message = error.message();
+        fs::remove(partial_file_path, error);
+        throw BackupException("Could not move backup to " + destination_file_path.string() + ": " + message);
+    }
+    return true;
+}
+
+/// \brief Options for the in-memory database of the hybrid in-memory mode, without the settings that only apply to
+/// database files
+ConnectionOptions get_in_memory_options(ConnectionOptions options) {
+    options.journal_mode.reset();
+    options.mmap_size.reset();
+    options.locking_mode.reset();
+    return options;
+}
+
+// The truncate optimization shows up as a Clear opcode in the program of the DELETE
+bool uses_truncate_optimization(sqlite3* db, const std::string& delete_sql) {
+    Statement explain{db, "EXPLAIN " + delete_sql};
+    while (explain.step() == SQLITE_ROW) {
+        if (explain.column_text_view(1) == "Clear") {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::int64_t query_int64(sqlite3* db, const std::string& sql) {
+    Statement statement{db, sql};
+    if (statement.step() != SQLITE_ROW) {
+        throw QueryExecutionException(sql + " failed: " + sqlite3_errmsg(db));
+    }
+    return statement.column_int64(0);
+}
+
+// Explains why SQLite can't use the truncate optimization for table
+std::string slow_truncate_reason(sqlite3* db, const std::string& table) {
+    Statement triggers{db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND tbl_name = ?"};
+    triggers.bind_text(1, table);
+    if (triggers.step() == SQLITE_ROW and triggers.column_int(0) > 0) {
+        return "has triggers";
+    }
+    Statement references{db, "SELECT COUNT(*) FROM sqlite_master AS m, pragma_foreign_key_list(m.name) AS f "
+                             "WHERE m.type = 'table' AND (m.name = ?1 OR f.\"table\" = ?1 COLLATE NOCASE)"};
+    references.bind_text(1, table);
+    if (references.step() == SQLITE_ROW and references.column_int(0) > 0) {
+        return "has foreign keys or is referenced by them";
+    }
+    return "can't use the truncate optimization";
+}
+
+int count_commit(void* commit_count) {
+    static_cast<std::atomic_uint64_t*>(commit_count)->fetch_add(1);
+    return 0; // Don't turn the commit into a rollback
+}
+} // namespace
+
 Connection::Connection(const fs::path& database_file_path) noexcept :
-    db(nullptr), database_file_path(database_file_path), open_count(0) {
+    Connection(database_file_path, ConnectionOptions{}) {
+}
+
+Connection::Connection(const fs::path& database_file_path, const ConnectionOptions& options) noexcept :
+    db(nullptr),
+    database_file_path(database_file_path),
+    options(options),
+    open_count(0),
+    savepoint_depth(0),
+    statement_cache(options.statement_cache_capacity),
+    profiling_enabled(false),
+    running_backups(0),
+    destroying(false),
+    snapshot_stop(false),
+    commit_count(0),
+    snapshot_commit_count(0),
+    checkpoint_scheduler(options.checkpoint.has_value() ? std::make_unique<CheckpointScheduler>(*options.checkpoint)
+                                                        : nullptr),
+    busy_handler(options.busy_retry.has_value() ? std::make_unique<BusyHandler>(*options.busy_retry) : nullptr) {
+    this->query_limiter.set_statement_timeout(options.query_timeout);
 }
 
 Connection::~Connection() {
+    {
+        // Running backups use the database handle, so cancel them and wait until they are stopped
+        this->destroying = true;
+        std::unique_lock lock(this->backup_mutex);
+        this->backup_finished.wait(lock, [this]() { return this->running_backups == 0; });
+    }
+
     // There could still be a transaction active and we have no way to abort it,
     // so wait a few seconds to give it time to finish
     auto lock = std::unique_lock(this->transaction_mutex, 2s);
@@ -71,19 +327,179 @@ bool Connection::open_connection() {
         fs::create_directories(this->database_file_path.parent_path());
     }
 
-    if (sqlite3_open_v2(this->database_file_path.c_str(), &this->db,
-                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI, nullptr) != SQLITE_OK) {
+    const bool in_memory = this->options.in_memory_snapshot.has_value();
+    const fs::path open_path = in_memory ? fs::path{":memory:"} : this->database_file_path;
+    if (sqlite3_open_v2(open_path.c_str(), &this->db, this->options.open_flags, nullptr) != SQLITE_OK) {
         EVLOG_error << "Error opening database at " << this->database_file_path << ": " << sqlite3_errmsg(db);
         return false;
     }
+
+    // Snapshots are serialized on another thread while the database is in use, like backups this needs the mutex
+    // of the serialized threading mode
+    if (in_memory and sqlite3_db_mutex(this->db) == nullptr) {
+        EVLOG_error << "Database " << this->database_file_path
+                    << " can't be kept in memory, snapshots need a connection in serialized threading mode";
+        sqlite3_close_v2(this->db);
+        this->db = nullptr;
+        this->open_count--;
+        return false;
+    }
+
+    if (this->busy_handler != nullptr) {
+        this->busy_handler->attach(this->db);
+    }
+
+    // Either all options are active or the connection is not opened at all
+    if ((in_memory and !this->load_snapshot()) or
+        !apply_connection_options(this->db, in_memory ? get_in_memory_options(this->options) : this->options) or
+        (!in_memory and this->checkpoint_scheduler != nullptr and !this->checkpoint_scheduler->attach(this->db))) {
+        EVLOG_error << "Error configuring database at " << this->database_file_path;
+        sqlite3_close_v2(this->db);
+        this->db = nullptr;
+        this->open_count--;
+        return false;
+    }
+
+    if (in_memory) {
+        sqlite3_commit_hook(this->db, count_commit, &this->commit_count);
+        this->snapshot_commit_count = this->commit_count;
+        const auto interval = this->options.in_memory_snapshot->flush_interval;
+        if (interval.count() > 0) {
+            this->snapshot_stop = false;
+            this->snapshot_thread = std::thread(&Connection::run_snapshot_flushes, this, interval);
+        }
+    }
+
+    {
+        const std::lock_guard lock(this->profiler_mutex);
+        if (this->profiling_enabled) {
+            this->profiler->attach(this->db);
+        }
+    }
+    this->query_limiter.attach(this->db);
     EVLOG_debug << "Established connection to database: " << this->database_file_path;
     return true;
 }
 
+const ConnectionOptions& Connection::get_options() const {
+    return this->options;
+}
+
+bool Connection::flush_snapshot() {
+    if (!this->options.in_memory_snapshot.has_value()) {
+        EVLOG_error << "Database " << this->database_file_path << " is not kept in memory";
+        return false;
+    }
+    const std::lock_guard lock(this->snapshot_mutex);
+    return this->write_snapshot();
+}
+
+bool Connection::load_snapshot() {
+    if (!fs::exists(this->database_file_path)) {
+        return true;
+    }
+
+    sqlite3* file = nullptr;
+    if (sqlite3_open_v2(this->database_file_path.c_str(), &file, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        EVLOG_error << "Error opening database file " << this->database_file_path << ": " << sqlite3_errmsg(file);
+        sqlite3_close_v2(file);
+        return false;
+    }
+    sqlite3_int64 size = 0;
+    unsigned char* image = sqlite3_serialize(file, "main", &size, 0);
+    sqlite3_close_v2(file);
+    if (image == nullptr) {
+        if (size == 0) {
+            return true; // Empty file
+        }
+        EVLOG_error << "Could not read database file " << this->database_file_path;
+        return false;
+    }
+
+    // Bytes 18 and 19 of the header mark a WAL database, which an in-memory database can't use
+    if (size > 19 and image[18] == 2) {
+        image[18] = 1;
+        image[19] = 1;
+    }
+    // SQLite owns the image from now on, even if this fails
+    if (sqlite3_deserialize(this->db, "main", image, size, size,
+                            SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE) != SQLITE_OK) {
+        EVLOG_error << "Could not load database file " << this->database_file_path << ": " << sqlite3_errmsg(this->db);
+        return false;
+    }
+    EVLOG_debug << "Loaded " << size << " bytes from " << this->database_file_path << " into memory";
+    return true;
+}
+
+bool Connection::write_snapshot() {
+    if (this->db == nullptr) {
+        return false;
+    }
+    const std::uint64_t commits = this->commit_count;
+    if (commits == this->snapshot_commit_count and fs::exists(this->database_file_path)) {
+        return true;
+    }
+
+    // Serializing inside a transaction would include its uncommitted changes. Holding the database mutex keeps other
+    // threads from starting one in between.
+    sqlite3_int64 size = 0;
+    unsigned char* image = nullptr;
+    sqlite3_mutex* mutex = sqlite3_db_mutex(this->db);
+    sqlite3_mutex_enter(mutex);
+    const bool in_transaction = sqlite3_get_autocommit(this->db) == 0;
+    if (!in_transaction) {
+        image = sqlite3_serialize(this->db, "main", &size, 0);
+    }
+    sqlite3_mutex_leave(mutex);
+    if (in_transaction) {
+        EVLOG_debug << "Snapshot of " << this->database_file_path << " postponed, a transaction is open";
+        return false;
+    }
+
+    sqlite3* snapshot = nullptr;
+    const int open_result = sqlite3_open_v2(":memory:", &snapshot, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (image == nullptr or open_result != SQLITE_OK or
+        sqlite3_deserialize(snapshot, "main", image, size, size,
+                            SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_READONLY) != SQLITE_OK) {
+        EVLOG_error << "Could not create snapshot of " << this->database_file_path;
+        if (image != nullptr and open_result != SQLITE_OK) {
+            sqlite3_free(image);
+        }
+        sqlite3_close_v2(snapshot);
+        return false;
+    }
+
+    bool written = false;
+    try {
+        written = copy_to_file(snapshot, this->database_file_path, -1, 0ms, nullptr);
+    } catch (const BackupException& e) {
+        EVLOG_error << "Could not write snapshot: " << e.what();
+    }
+    sqlite3_close_v2(snapshot);
+    if (written) {
+        this->snapshot_commit_count = commits;
+    }
+    return written;
+}
+
+void Connection::run_snapshot_flushes(std::chrono::milliseconds interval) {
+    std::unique_lock lock(this->snapshot_mutex);
+    while (!this->snapshot_stop_requested.wait_for(lock, interval, [this]() { return this->snapshot_stop; })) {
+        this->write_snapshot();
+    }
+}
+
 bool Connection::close_connection() {
     return this->close_connection_internal(false);
 }
 
+CheckpointStats Connection::get_checkpoint_stats() const {
+    if (this->checkpoint_scheduler == nullptr) {
+        return {};
+    }
+    return this->checkpoint_scheduler->get_stats();
+}
+
 bool Connection::close_connection_internal(bool force_close) {
     if (!force_close && this->open_count.fetch_sub(1) != 1) {
         EVLOG_debug << "Connection should remain open for other users";
@@ -95,12 +511,39 @@ bool Connection::close_connection_internal(bool force_close) {
         return true;
     }
 
+    if (this->snapshot_thread.joinable()) {
+        {
+            const std::lock_guard lock(this->snapshot_mutex);
+            this->snapshot_stop = true;
+        }
+        this->snapshot_stop_requested.notify_all();
+        this->snapshot_thread.join();
+    }
+    if (this->checkpoint_scheduler != nullptr) {
+        this->checkpoint_scheduler->detach();
+    }
+    this->query_limiter.detach();
+
+    // cached statements are finalized by the cache so it doesn't keep dangling handles
+    this->statement_cache.clear();
+
     // forcefully finalize all statements before calling sqlite3_close
     sqlite3_stmt* stmt = nullptr;
     while ((stmt = sqlite3_next_stmt(db, stmt)) != nullptr) {
         sqlite3_finalize(stmt);
     }
 
+    if (this->options.in_memory_snapshot.has_value()) {
+        // Closing rolls back an open transaction anyway, do it first so the committed state can be written
+        if (sqlite3_get_autocommit(this->db) == 0) {
+            EVLOG_warning << "Rolling back the open transaction of " << this->database_file_path << " before closing";
+            sqlite3_exec(this->db, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+        if (!this->flush_snapshot()) {
+            EVLOG_error << "Changes to the in-memory database " << this->database_file_path << " are lost";
+        }
+    }
+
     if (sqlite3_close_v2(this->db) != SQLITE_OK) {
         EVLOG_error << "Error closing database file " << this->database_file_path << ": " << this->get_error_message();
         return false;
@@ -110,14 +553,52 @@ bool Connection::close_connection_internal(bool force_close) {
     return true;
 }
 
-bool Connection::execute_statement(const std::string& statement) {
+int Connection::execute_sql(const std::string& sql) {
     char* err_msg = nullptr;
-    if (sqlite3_exec(this->db, statement.c_str(), nullptr, nullptr, &err_msg) != SQLITE_OK) {
-        EVLOG_error << "Could not execute statement \"" << statement << "\": " << err_msg;
+    const auto result = sqlite3_exec(this->db, sql.c_str(), nullptr, nullptr, &err_msg);
+    if (result != SQLITE_OK) {
+        EVLOG_error << "Could not execute statement \"" << sql << "\": " << err_msg;
         sqlite3_free(err_msg);
-        return false;
     }
-    return true;
+    return result;
+}
+
+bool Connection::execute_statement(const std::string& statement) {
+    std::optional<QueryGuard> guard;
+    const auto deadline = this->query_limiter.statement_deadline();
+    if (deadline.has_value()) {
+        guard.emplace(this->query_limiter, QueryLimiter::Limit{deadline, std::nullopt});
+    }
+    return this->execute_sql(statement) == SQLITE_OK;
+}
+
+void Connection::enable_query_profiling(const QueryProfilerOptions& options) {
+    const std::lock_guard lock(this->profiler_mutex);
+    if (this->profiler == nullptr) {
+        this->profiler = std::make_unique<QueryProfiler>(options);
+    } else {
+        this->profiler->set_options(options);
+    }
+    this->profiling_enabled = true;
+    if (this->db != nullptr) {
+        this->profiler->attach(this->db);
+    }
+}
+
+void Connection::disable_query_profiling() {
+    const std::lock_guard lock(this->profiler_mutex);
+    this->profiling_enabled = false;
+    if (this->db != nullptr) {
+        QueryProfiler::detach(this->db);
+    }
+}
+
+QueryProfile Connection::get_query_profile(bool reset) {
+    const std::lock_guard lock(this->profiler_mutex);
+    if (this->profiler == nullptr) {
+        return {};
+    }
+    return this->profiler->snapshot(reset);
 }
 
 const char* Connection::get_error_message() {
@@ -125,17 +606,102 @@ const char* Connection::get_error_message() {
 }
 
 std::unique_ptr<TransactionInterface> Connection::begin_transaction() {
-    return std::make_unique<DatabaseTransaction>(*this, std::unique_lock(this->transaction_mutex));
+    return this->begin_transaction(TransactionOptions{});
+}
+
+std::unique_ptr<TransactionInterface> Connection::begin_transaction(const TransactionOptions& options) {
+    // Only the owner can find itself here, other threads always see a different id
+    if (this->transaction_owner.load() == std::this_thread::get_id()) {
+        return std::make_unique<SavepointTransaction>(*this);
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (options.timeout.has_value()) {
+        deadline = std::chrono::steady_clock::now() + options.timeout.value();
+    }
+    if (!this->transaction_mutex.lock(options.priority, deadline)) {
+        EVLOG_warning << "Timeout after " << options.timeout.value().count() << "ms waiting for a transaction";
+        return nullptr;
+    }
+    return std::make_unique<DatabaseTransaction>(*this, std::unique_lock(this->transaction_mutex, std::adopt_lock),
+                                                 options.mode);
+}
+
+void Connection::interrupt() {
+    this->query_limiter.interrupt();
+}
+
+BusyStats Connection::get_busy_stats() const {
+    if (this->busy_handler == nullptr) {
+        return {};
+    }
+    return this->busy_handler->get_stats();
+}
+
+QueryInterruptStats Connection::get_query_interrupt_stats() const {
+    return this->query_limiter.get_stats();
+}
+
+TransactionLockStats Connection::get_transaction_lock_stats() {
+    return this->transaction_mutex.get_stats();
 }
 
 std::unique_ptr<StatementInterface> Connection::new_statement(const std::string& sql) {
-    return std::make_unique<Statement>(this->db, sql);
+    return this->statement_cache.acquire(this->db, sql,
+                                         this->options.query_timeout.has_value() ? &this->query_limiter : nullptr);
+}
+
+std::unique_ptr<BlobStreamInterface> Connection::open_blob(const std::string& table, const std::string& column,
+                                                           int64_t rowid, bool writable) {
+    return std::make_unique<BlobStream>(this->db, table, column, rowid, writable);
+}
+
+void Connection::set_statement_cache_capacity(std::size_t capacity) {
+    this->statement_cache.set_capacity(capacity);
+}
+
+StatementCacheStats Connection::get_statement_cache_stats() const {
+    return this->statement_cache.get_stats();
 }
 
 bool Connection::clear_table(const std::string& table) {
     return this->execute_statement("DELETE FROM "s + table);
 }
 
+TruncateResult Connection::truncate_tables(const std::vector<std::string>& tables, const TruncateOptions& options) {
+    TruncateResult result;
+    {
+        auto transaction = this->begin_transaction();
+        for (const auto& table : tables) {
+            const auto sql = "DELETE FROM " + quote_identifier(table);
+            if (!uses_truncate_optimization(this->db, sql)) {
+                EVLOG_warning << "Table " << table << " is cleared row by row, it "
+                              << slow_truncate_reason(this->db, table);
+                result.slow_tables.push_back(table);
+            }
+            result.rows_deleted += this->execute(sql).changes;
+        }
+        transaction->commit();
+    }
+
+    if (options.vacuum_pages != 0) {
+        if (query_int64(this->db, "PRAGMA auto_vacuum") != 2) {
+            EVLOG_warning << "Free pages of " << this->database_file_path
+                          << " are kept, auto_vacuum is not incremental";
+            return result;
+        }
+        const auto free_pages = query_int64(this->db, "PRAGMA freelist_count");
+        const auto pages = options.vacuum_pages > 0 ? options.vacuum_pages : 0; // 0 returns all free pages
+        auto transaction = this->begin_transaction();
+        if (!this->execute_statement("PRAGMA incremental_vacuum(" + std::to_string(pages) + ")")) {
+            throw QueryExecutionException("Incremental vacuum failed: "s + this->get_error_message());
+        }
+        transaction->commit();
+        result.pages_vacuumed = free_pages - query_int64(this->db, "PRAGMA freelist_count");
+    }
+    return result;
+}
+
 int64_t Connection::get_last_inserted_rowid() {
     return sqlite3_last_insert_rowid(this->db);
 }
@@ -157,4 +723,143 @@ void Connection::set_user_version(uint32_t version) {
     }
 }
 
+int Connection::get_limit(int limit_id) {
+    if (this->db == nullptr) {
+        return -1;
+    }
+    return sqlite3_limit(this->db, limit_id, -1);
+}
+
+ConnectionStats Connection::stats(bool reset) {
+    ConnectionStats stats;
+    if (this->db == nullptr) {
+        return stats;
+    }
+
+    const int reset_flag = reset ? 1 : 0;
+    const auto status = [this](int op, int reset_flag, std::int64_t* current, std::int64_t* highwater) {
+        int current_value = 0;
+        int highwater_value = 0;
+        if (sqlite3_db_status(this->db, op, &current_value, &highwater_value, reset_flag) != SQLITE_OK) {
+            return;
+        }
+        if (current != nullptr) {
+            *current = current_value;
+        }
+        if (highwater != nullptr) {
+            *highwater = highwater_value;
+        }
+    };
+
+    status(SQLITE_DBSTATUS_CACHE_HIT, reset_flag, &stats.cache_hits, nullptr);
+    status(SQLITE_DBSTATUS_CACHE_MISS, reset_flag, &stats.cache_misses, nullptr);
+    status(SQLITE_DBSTATUS_CACHE_WRITE, reset_flag, &stats.cache_writes, nullptr);
+#ifdef SQLITE_DBSTATUS_CACHE_SPILL
+    status(SQLITE_DBSTATUS_CACHE_SPILL, reset_flag, &stats.cache_spills, nullptr);
+#endif
+    status(SQLITE_DBSTATUS_CACHE_USED, 0, &stats.cache_used, nullptr);
+    status(SQLITE_DBSTATUS_CACHE_USED_SHARED, 0, &stats.cache_used_shared, nullptr);
+    status(SQLITE_DBSTATUS_LOOKASIDE_USED, reset_flag, &stats.lookaside_used, &stats.lookaside_highwater);
+    // For the lookaside hit and miss counters SQLite reports the value as highwater mark
+    status(SQLITE_DBSTATUS_LOOKASIDE_HIT, reset_flag, nullptr, &stats.lookaside_hits);
+    status(SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, reset_flag, nullptr, &stats.lookaside_miss_size);
+    status(SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, reset_flag, nullptr, &stats.lookaside_miss_full);
+    status(SQLITE_DBSTATUS_SCHEMA_USED, 0, &stats.schema_used, nullptr);
+    status(SQLITE_DBSTATUS_STMT_USED, 0, &stats.statements_used, nullptr);
+    status(SQLITE_DBSTATUS_DEFERRED_FKS, 0, &stats.deferred_foreign_keys, nullptr);
+    return stats;
+}
+
+bool Connection::restore_from(const fs::path& source_file_path) {
+    if (this->db == nullptr) {
+        EVLOG_error << "Can't restore into a closed database";
+        return false;
+    }
+
+    // The backup can't replace the database while this connection has a transaction open
+    std::unique_lock<PriorityTimedMutex> lock{this->transaction_mutex, std::try_to_lock};
+    if (!lock.owns_lock()) {
+        EVLOG_error << "Can't restore the database while a transaction is active";
+        return false;
+    }
+
+    sqlite3* source = nullptr;
+    if (sqlite3_open_v2(source_file_path.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        EVLOG_error << "Error opening database " << source_file_path << " to restore from: " << sqlite3_errmsg(source);
+        sqlite3_close_v2(source);
+        return false;
+    }
+
+    sqlite3_backup* backup = sqlite3_backup_init(this->db, "main", source, "main");
+    if (backup == nullptr) {
+        EVLOG_error << "Could not start restoring from " << source_file_path << ": " << sqlite3_errmsg(this->db);
+        sqlite3_close_v2(source);
+        return false;
+    }
+
+    const int result = sqlite3_backup_step(backup, -1);
+    sqlite3_backup_finish(backup);
+    sqlite3_close_v2(source);
+
+    if (result != SQLITE_DONE) {
+        EVLOG_error << "Could not restore from " << source_file_path << ": " << sqlite3_errstr(result);
+        return false;
+    }
+
+    // Statements prepared against the old schema would only be re-prepared on first use
+    this->statement_cache.clear();
+    return true;
+}
+
+std::future<bool> Connection::backup_to(const fs::path& destination_file_path, const BackupOptions& options) {
+    std::promise<bool> result;
+    auto future = result.get_future();
+    if (this->db == nullptr) {
+        result.set_exception(std::make_exception_ptr(BackupException("Can't backup a closed database")));
+        return future;
+    }
+
+    // Keeps the database open while the backup thread uses it
+    this->open_connection();
+    {
+        const std::lock_guard lock(this->backup_mutex);
+        this->running_backups++;
+    }
+
+    std::thread([this, destination_file_path, options, result = std::move(result)]() mutable {
+        try {
+            result.set_value(this->backup(destination_file_path, options));
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+        this->close_connection();
+
+        const std::lock_guard lock(this->backup_mutex);
+        this->running_backups--;
+        this->backup_finished.notify_all();
+    }).detach();
+    return future;
+}
+
+bool Connection::backup(const fs::path& destination_file_path, const BackupOptions& options) {
+    if (sqlite3_db_mutex(this->db) == nullptr) {
+        throw BackupException("Backups need a connection in serialized threading mode");
+    }
+
+    const auto cancelled = [this, &options]() { return options.cancellation.is_cancelled() or this->destroying; };
+    const auto after_step = [&options, &cancelled](const BackupProgress& progress) {
+        if (options.on_progress) {
+            options.on_progress(progress);
+        }
+        return !cancelled();
+    };
+    if (cancelled() or !copy_to_file(this->db, destination_file_path, options.pages_per_step,
+                                     options.pause_between_steps, after_step)) {
+        EVLOG_info << "Backup to " << destination_file_path << " cancelled";
+        return false;
+    }
+    EVLOG_debug << "Backup of " << this->database_file_path << " written to " << destination_file_path;
+    return true;
+}
+
 } // namespace everest::db::sqlite
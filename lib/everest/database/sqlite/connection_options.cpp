@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection_options.hpp>
+#include <everest/database/sqlite/statement.hpp>
+#include <everest/logging.hpp>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+namespace everest::db::sqlite {
+
+namespace {
+const char* to_string(JournalMode mode) {
+    switch (mode) {
+    case JournalMode::Delete:
+        return "delete";
+    case JournalMode::Truncate:
+        return "truncate";
+    case JournalMode::Persist:
+        return "persist";
+    case JournalMode::Memory:
+        return "memory";
+    case JournalMode::Wal:
+        return "wal";
+    case JournalMode::Off:
+    default:
+        return "off";
+    }
+}
+
+const char* to_string(LockingMode mode) {
+    return mode == LockingMode::Exclusive ? "exclusive" : "normal";
+}
+
+// Executes a PRAGMA and returns the first column of the first row, if any
+std::optional<std::string> query_pragma(sqlite3* db, const std::string& pragma) {
+    Statement statement{db, "PRAGMA "s + pragma};
+    const auto result = statement.step();
+    if (result == SQLITE_ROW) {
+        return statement.column_text_nullable(0);
+    }
+    if (result != SQLITE_DONE) {
+        throw QueryExecutionException("PRAGMA "s + pragma + " failed: " + sqlite3_errmsg(db));
+    }
+    return std::nullopt;
+}
+
+std::int64_t query_pragma_int(sqlite3* db, const std::string& pragma) {
+    const auto value = query_pragma(db, pragma);
+    if (!value.has_value()) {
+        throw QueryExecutionException("PRAGMA "s + pragma + " returned no value");
+    }
+    return std::stoll(value.value());
+}
+
+void set_and_verify(sqlite3* db, const std::string& pragma, std::int64_t value) {
+    query_pragma(db, pragma + " = " + std::to_string(value));
+    const auto actual = query_pragma_int(db, pragma);
+    if (actual != value) {
+        throw ConnectionException(pragma + " is " + std::to_string(actual) + " instead of " + std::to_string(value));
+    }
+}
+
+// For settings SQLite is allowed to adjust (e.g. capped by compile time limits) only a warning is logged
+void set_and_check(sqlite3* db, const std::string& pragma, std::int64_t value) {
+    query_pragma(db, pragma + " = " + std::to_string(value));
+    const auto actual = query_pragma_int(db, pragma);
+    if (actual != value) {
+        EVLOG_warning << pragma << " is " << actual << " instead of the requested " << value;
+    }
+}
+
+void set_and_verify(sqlite3* db, const std::string& pragma, const std::string& value) {
+    const auto actual = query_pragma(db, pragma + " = " + value);
+    if (actual.value_or("") != value) {
+        throw ConnectionException(pragma + " is " + actual.value_or("unknown") + " instead of " + value);
+    }
+}
+} // namespace
+
+ConnectionOptions ConnectionOptions::flash_friendly() {
+    ConnectionOptions options;
+    options.journal_mode = JournalMode::Wal;
+    options.synchronous = SynchronousMode::Normal;
+    options.temp_store = TempStore::Memory;
+    options.cache_size = -2048; // 2 MiB
+    options.busy_timeout = 5s;
+    return options;
+}
+
+ConnectionOptions ConnectionOptions::max_throughput() {
+    ConnectionOptions options;
+    options.journal_mode = JournalMode::Wal;
+    options.synchronous = SynchronousMode::Normal;
+    options.temp_store = TempStore::Memory;
+    options.cache_size = -16384;             // 16 MiB
+    options.mmap_size = 256LL * 1024 * 1024; // 256 MiB
+    options.busy_timeout = 5s;
+    options.statement_cache_capacity = 128;
+    return options;
+}
+
+ConnectionOptions ConnectionOptions::in_memory_test() {
+    ConnectionOptions options;
+    options.journal_mode = JournalMode::Memory;
+    options.synchronous = SynchronousMode::Off;
+    options.temp_store = TempStore::Memory;
+    return options;
+}
+
+bool apply_connection_options(sqlite3* db, const ConnectionOptions& options) {
+    try {
+        // The busy timeout goes first so the following PRAGMAs wait for other connections instead of failing. With
+        // busy_retry the connection has installed its busy handler already, which a busy timeout would replace.
+        if (options.busy_timeout.has_value() and !options.busy_retry.has_value()) {
+            sqlite3_busy_timeout(db, static_cast<int>(options.busy_timeout->count()));
+            set_and_verify(db, "busy_timeout", options.busy_timeout->count());
+        }
+        // The page size can't be changed anymore once the database is in WAL mode
+        if (options.page_size.has_value()) {
+            set_and_check(db, "page_size", options.page_size.value());
+        }
+        // Like the page size, the auto vacuum mode is written when the first table is created
+        if (options.auto_vacuum.has_value()) {
+            set_and_check(db, "auto_vacuum", static_cast<std::int64_t>(options.auto_vacuum.value()));
+        }
+        if (options.locking_mode.has_value()) {
+            set_and_verify(db, "locking_mode", to_string(options.locking_mode.value()));
+        }
+        if (options.journal_mode.has_value()) {
+            set_and_verify(db, "journal_mode", to_string(options.journal_mode.value()));
+        }
+        if (options.synchronous.has_value()) {
+            set_and_verify(db, "synchronous", static_cast<std::int64_t>(options.synchronous.value()));
+        }
+        if (options.cache_size.has_value()) {
+            set_and_verify(db, "cache_size", options.cache_size.value());
+        }
+        if (options.mmap_size.has_value()) {
+            set_and_check(db, "mmap_size", options.mmap_size.value());
+        }
+        if (options.temp_store.has_value()) {
+            set_and_verify(db, "temp_store", static_cast<std::int64_t>(options.temp_store.value()));
+        }
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not apply connection options: " << e.what();
+        return false;
+    }
+    return true;
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <chrono>
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection_pool.hpp>
+#include <everest/logging.hpp>
+
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+struct ReaderLease::Reader {
+    sqlite3* db{nullptr};
+    StatementCache statement_cache;
+
+    explicit Reader(std::size_t statement_cache_capacity) : statement_cache(statement_cache_capacity) {
+    }
+
+    void close(const fs::path& database_file_path) {
+        this->statement_cache.clear();
+        sqlite3_stmt* stmt = nullptr;
+        while ((stmt = sqlite3_next_stmt(this->db, stmt)) != nullptr) {
+            sqlite3_finalize(stmt);
+        }
+        if (sqlite3_close_v2(this->db) != SQLITE_OK) {
+            EVLOG_error << "Error closing reader connection to " << database_file_path << ": "
+                        << sqlite3_errmsg(this->db);
+        }
+        this->db = nullptr;
+    }
+};
+
+namespace {
+// Options are taken by value: copying into a named local and returning it makes GCC 12 crash while inlining into
+// the noexcept constructors at -O1 and above
+ConnectionOptions get_writer_options(ConnectionOptions writer_options) {
+    writer_options.journal_mode = JournalMode::Wal;
+    return writer_options;
+}
+
+ConnectionOptions get_reader_options(ConnectionOptions reader_options) {
+    reader_options.open_flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI;
+    // These are properties of the database file and are owned by the writer
+    reader_options.journal_mode.reset();
+    reader_options.synchronous.reset();
+    reader_options.page_size.reset();
+    reader_options.locking_mode.reset();
+    // Readers don't write to the WAL, checkpoints are scheduled by the writer
+    reader_options.checkpoint.reset();
+    return reader_options;
+}
+} // namespace
+
+ReaderLease::ReaderLease(ConnectionPool* pool, Reader* reader) noexcept : pool(pool), reader(reader) {
+}
+
+ReaderLease::ReaderLease(ReaderLease&& other) noexcept : pool(other.pool), reader(other.reader) {
+    other.pool = nullptr;
+    other.reader = nullptr;
+}
+
+ReaderLease& ReaderLease::operator=(ReaderLease&& other) noexcept {
+    if (this != &other) {
+        if (this->reader != nullptr) {
+            this->pool->release_reader(this->reader);
+        }
+        this->pool = other.pool;
+        this->reader = other.reader;
+        other.pool = nullptr;
+        other.reader = nullptr;
+    }
+    return *this;
+}
+
+ReaderLease::~ReaderLease() {
+    if (this->reader != nullptr) {
+        this->pool->release_reader(this->reader);
+    }
+}
+
+std::unique_ptr<StatementInterface> ReaderLease::new_statement(const std::string& sql) {
+    return this->reader->statement_cache.acquire(this->reader->db, sql);
+}
+
+std::unique_ptr<BlobStreamInterface> ReaderLease::open_blob(const std::string& table, const std::string& column,
+                                                            int64_t rowid) {
+    return std::make_unique<BlobStream>(this->reader->db, table, column, rowid, false);
+}
+
+const char* ReaderLease::get_error_message() {
+    return sqlite3_errmsg(this->reader->db);
+}
+
+ReadSnapshot::ReadSnapshot(ReaderLease lease) : lease(std::move(lease)) {
+    sqlite3* db = this->lease.reader->db;
+    // In WAL mode the snapshot is taken by the first read of the transaction, not by BEGIN
+    if (sqlite3_exec(db, "BEGIN TRANSACTION; SELECT COUNT(*) FROM sqlite_master;", nullptr, nullptr, nullptr) !=
+        SQLITE_OK) {
+        const std::string message = sqlite3_errmsg(db);
+        if (sqlite3_get_autocommit(db) == 0) {
+            sqlite3_exec(db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+        }
+        throw QueryExecutionException("Could not begin read snapshot: " + message);
+    }
+}
+
+ReadSnapshot::~ReadSnapshot() {
+    this->end();
+}
+
+std::unique_ptr<StatementInterface> ReadSnapshot::new_statement(const std::string& sql) {
+    return this->lease.new_statement(sql);
+}
+
+std::unique_ptr<BlobStreamInterface> ReadSnapshot::open_blob(const std::string& table, const std::string& column,
+                                                             int64_t rowid) {
+    return this->lease.open_blob(table, column, rowid);
+}
+
+const char* ReadSnapshot::get_error_message() {
+    return this->lease.get_error_message();
+}
+
+void ReadSnapshot::end() {
+    if (this->lease.reader == nullptr) {
+        return;
+    }
+    // A read transaction has nothing to commit, ending it can't fail once its statements are reset
+    if (sqlite3_exec(this->lease.reader->db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        EVLOG_error << "Could not end read snapshot: " << sqlite3_errmsg(this->lease.reader->db);
+        sqlite3_exec(this->lease.reader->db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+    }
+    // Returns the reader to the pool
+    ReaderLease released{std::move(this->lease)};
+}
+
+ConnectionPool::ConnectionPool(const fs::path& database_file_path, std::size_t reader_count) noexcept :
+    ConnectionPool(database_file_path, reader_count, ConnectionOptions{}) {
+}
+
+ConnectionPool::ConnectionPool(const fs::path& database_file_path, std::size_t reader_count,
+                               const ConnectionOptions& options) noexcept :
+    writer(database_file_path, get_writer_options(options)),
+    database_file_path(database_file_path),
+    reader_options(get_reader_options(options)),
+    reader_count(reader_count),
+    open_count(0) {
+}
+
+ConnectionPool::~ConnectionPool() {
+    if (this->open_count.load() != 0) {
+        this->close_readers();
+    }
+}
+
+bool ConnectionPool::open_connection() {
+    if (this->open_count.fetch_add(1) != 0) {
+        EVLOG_debug << "Connection pool already opened";
+        return true;
+    }
+
+    if (this->database_file_path.string().find(":memory:") != std::string::npos or
+        this->database_file_path.string().find("mode=memory") != std::string::npos) {
+        EVLOG_error << "Connection pool requires a database file, in-memory databases are not supported: "
+                    << this->database_file_path;
+        this->open_count--;
+        return false;
+    }
+
+    // The writer options enforce WAL mode, opening fails if the database can't be switched to it
+    if (!this->writer.open_connection()) {
+        this->open_count--;
+        return false;
+    }
+
+    if (!this->open_readers()) {
+        this->close_readers();
+        this->writer.close_connection();
+        this->open_count--;
+        return false;
+    }
+
+    EVLOG_debug << "Opened connection pool with " << this->reader_count << " readers for database "
+                << this->database_file_path;
+    return true;
+}
+
+bool ConnectionPool::close_connection() {
+    if (this->open_count.fetch_sub(1) != 1) {
+        EVLOG_debug << "Connection pool should remain open for other users";
+        return true;
+    }
+
+    this->close_readers();
+    return this->writer.close_connection();
+}
+
+bool ConnectionPool::open_readers() {
+    const std::lock_guard lock(this->readers_mutex);
+    for (std::size_t i = 0; i < this->reader_count; i++) {
+        auto reader = std::make_unique<ReaderLease::Reader>(this->reader_options.statement_cache_capacity);
+        const auto result = sqlite3_open_v2(this->database_file_path.c_str(), &reader->db,
+                                            this->reader_options.open_flags, nullptr);
+        if (result != SQLITE_OK) {
+            EVLOG_error << "Error opening reader connection to " << this->database_file_path << ": "
+                        << sqlite3_errmsg(reader->db);
+            sqlite3_close_v2(reader->db);
+            return false;
+        }
+        if (!apply_connection_options(reader->db, this->reader_options)) {
+            EVLOG_error << "Error configuring reader connection to " << this->database_file_path;
+            sqlite3_close_v2(reader->db);
+            return false;
+        }
+        this->idle_readers.push_back(reader.get());
+        this->readers.push_back(std::move(reader));
+    }
+    return true;
+}
+
+void ConnectionPool::close_readers() {
+    std::unique_lock lock(this->readers_mutex);
+    // Give leases that are still in use a few seconds to be returned, like Connection does for transactions
+    if (!this->reader_returned.wait_for(lock, 2s,
+                                        [this]() { return this->idle_readers.size() == this->readers.size(); })) {
+        EVLOG_warning << "Closing connection pool while readers are still leased, they are closed once returned";
+    }
+
+    for (auto& reader : this->readers) {
+        if (std::find(this->idle_readers.begin(), this->idle_readers.end(), reader.get()) !=
+            this->idle_readers.end()) {
+            reader->close(this->database_file_path);
+        } else {
+            // Statements and BLOBs of the lease still use the connection, tearing it down would leave them dangling
+            this->closed_readers.push_back(std::move(reader));
+        }
+    }
+    this->idle_readers.clear();
+    this->readers.clear();
+    lock.unlock();
+    this->reader_returned.notify_all();
+}
+
+void ConnectionPool::release_reader(ReaderLease::Reader* reader) {
+    {
+        const std::lock_guard lock(this->readers_mutex);
+        const auto is_reader = [reader](const auto& item) { return item.get() == reader; };
+        const auto owned = std::find_if(this->readers.begin(), this->readers.end(), is_reader);
+        if (owned != this->readers.end()) {
+            this->idle_readers.push_back(reader);
+        } else {
+            // The pool was closed while the reader was leased
+            const auto closed = std::find_if(this->closed_readers.begin(), this->closed_readers.end(), is_reader);
+            if (closed != this->closed_readers.end()) {
+                (*closed)->close(this->database_file_path);
+                this->closed_readers.erase(closed);
+            }
+        }
+    }
+    this->reader_returned.notify_all();
+}
+
+ReaderLease ConnectionPool::acquire_reader() {
+    std::unique_lock lock(this->readers_mutex);
+    if (this->readers.empty()) {
+        throw ConnectionException("Connection pool has no open reader connections");
+    }
+    this->reader_returned.wait(lock, [this]() { return !this->idle_readers.empty() or this->readers.empty(); });
+    if (this->idle_readers.empty()) {
+        throw ConnectionException("Connection pool was closed while waiting for a reader");
+    }
+    auto* reader = this->idle_readers.back();
+    this->idle_readers.pop_back();
+    return ReaderLease{this, reader};
+}
+
+ReadSnapshot ConnectionPool::begin_read_snapshot() {
+    return ReadSnapshot{this->acquire_reader()};
+}
+
+std::size_t ConnectionPool::get_reader_count() const {
+    return this->reader_count;
+}
+
+std::unique_ptr<TransactionInterface> ConnectionPool::begin_transaction() {
+    return this->writer.begin_transaction();
+}
+
+std::unique_ptr<TransactionInterface> ConnectionPool::begin_transaction(const TransactionOptions& options) {
+    return this->writer.begin_transaction(options);
+}
+
+bool ConnectionPool::execute_statement(const std::string& statement) {
+    return this->writer.execute_statement(statement);
+}
+
+std::unique_ptr<StatementInterface> ConnectionPool::new_statement(const std::string& sql) {
+    return this->writer.new_statement(sql);
+}
+
+std::unique_ptr<BlobStreamInterface> ConnectionPool::open_blob(const std::string& table, const std::string& column,
+                                                               int64_t rowid, bool writable) {
+    return this->writer.open_blob(table, column, rowid, writable);
+}
+
+const char* ConnectionPool::get_error_message() {
+    return this->writer.get_error_message();
+}
+
+bool ConnectionPool::clear_table(const std::string& table) {
+    return this->writer.clear_table(table);
+}
+
+TruncateResult ConnectionPool::truncate_tables(const std::vector<std::string>& tables, const TruncateOptions& options) {
+    return this->writer.truncate_tables(tables, options);
+}
+
+int64_t ConnectionPool::get_last_inserted_rowid() {
+    return this->writer.get_last_inserted_rowid();
+}
+
+uint32_t ConnectionPool::get_user_version() {
+    return this->writer.get_user_version();
+}
+
+void ConnectionPool::set_user_version(uint32_t version) {
+    this->writer.set_user_version(version);
+}
+
+int ConnectionPool::get_limit(int limit_id) {
+    return this->writer.get_limit(limit_id);
+}
+
+ConnectionStats ConnectionPool::stats(bool reset) {
+    return this->writer.stats(reset);
+}
+
+bool ConnectionPool::restore_from(const fs::path& source_file_path) {
+    return this->writer.restore_from(source_file_path);
+}
+
+std::future<bool> ConnectionPool::backup_to(const fs::path& destination_file_path, const BackupOptions& options) {
+    return this->writer.backup_to(destination_file_path, options);
+}
+
+} // namespace everest::db::sqlite
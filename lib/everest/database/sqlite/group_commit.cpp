@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <vector>
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/group_commit.hpp>
+#include <everest/logging.hpp>
+
+namespace everest::db::sqlite {
+
+GroupCommit::GroupCommit(ConnectionInterface* database, const GroupCommitOptions& options) :
+    database(database), options(options), running(true) {
+    this->worker = std::thread(&GroupCommit::run, this);
+}
+
+GroupCommit::~GroupCommit() {
+    {
+        const std::lock_guard lock(this->queue_mutex);
+        this->running = false;
+    }
+    this->queue_changed.notify_all();
+    this->worker.join();
+}
+
+std::future<void> GroupCommit::submit(Work work) {
+    Unit unit{std::move(work), {}, std::chrono::steady_clock::now(), false};
+    auto future = unit.committed.get_future();
+    {
+        const std::lock_guard lock(this->queue_mutex);
+        this->queue.push_back(std::move(unit));
+    }
+    this->queue_changed.notify_all();
+    return future;
+}
+
+std::future<void> GroupCommit::flush() {
+    Unit unit{nullptr, {}, std::chrono::steady_clock::now(), true};
+    auto future = unit.committed.get_future();
+    {
+        const std::lock_guard lock(this->queue_mutex);
+        this->queue.push_back(std::move(unit));
+    }
+    this->queue_changed.notify_all();
+    return future;
+}
+
+GroupCommitStats GroupCommit::get_stats() const {
+    const std::lock_guard lock(this->queue_mutex);
+    return this->stats;
+}
+
+void GroupCommit::run() {
+    std::unique_lock lock(this->queue_mutex);
+    while (true) {
+        this->queue_changed.wait(lock, [this]() { return !this->queue.empty() or !this->running; });
+        if (this->queue.empty()) {
+            // Stopped and everything pending is committed
+            return;
+        }
+        const auto deadline = this->queue.front().submitted + this->options.max_delay;
+        this->commit_group(deadline, lock);
+    }
+}
+
+void GroupCommit::commit_group(std::chrono::steady_clock::time_point deadline, std::unique_lock<std::mutex>& lock) {
+    lock.unlock();
+
+    std::unique_ptr<TransactionInterface> transaction;
+    std::exception_ptr begin_error;
+    try {
+        transaction = this->database->begin_transaction();
+    } catch (const std::exception& e) {
+        EVLOG_error << "Group commit could not begin transaction: " << e.what();
+        begin_error = std::current_exception();
+    }
+    if (transaction == nullptr and !begin_error) {
+        begin_error = std::make_exception_ptr(QueryExecutionException("Could not begin group commit transaction"));
+    }
+
+    auto execute_unit = [this](Unit& unit) {
+        try {
+            if (!this->database->execute_statement("SAVEPOINT group_commit_unit")) {
+                throw QueryExecutionException(this->database->get_error_message());
+            }
+            try {
+                unit.work(*this->database);
+            } catch (...) {
+                this->database->execute_statement("ROLLBACK TO group_commit_unit");
+                this->database->execute_statement("RELEASE group_commit_unit");
+                throw;
+            }
+            if (!this->database->execute_statement("RELEASE group_commit_unit")) {
+                throw QueryExecutionException(this->database->get_error_message());
+            }
+            return true;
+        } catch (...) {
+            unit.committed.set_exception(std::current_exception());
+            return false;
+        }
+    };
+
+    std::vector<std::promise<void>> group;
+    std::size_t units = 0;
+    std::size_t failed = 0;
+    bool flush = false;
+
+    lock.lock();
+    while (true) {
+        while (!this->queue.empty() and units < this->options.max_transactions and !flush) {
+            auto unit = std::move(this->queue.front());
+            this->queue.pop_front();
+            lock.unlock();
+
+            flush = unit.flush;
+            if (unit.flush) {
+                group.push_back(std::move(unit.committed));
+            } else if (transaction == nullptr) {
+                unit.committed.set_exception(begin_error);
+                failed++;
+            } else if (execute_unit(unit)) {
+                group.push_back(std::move(unit.committed));
+                units++;
+            } else {
+                failed++;
+            }
+
+            lock.lock();
+        }
+
+        if (flush or units >= this->options.max_transactions or !this->running or
+            std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        this->queue_changed.wait_until(lock, deadline, [this]() { return !this->queue.empty() or !this->running; });
+    }
+    lock.unlock();
+
+    // Nothing was committed without a transaction, so flushes of the group must not report success either
+    std::exception_ptr commit_error = begin_error;
+    if (transaction != nullptr) {
+        try {
+            transaction->commit();
+        } catch (...) {
+            commit_error = std::current_exception();
+        }
+    }
+
+    // Counters are updated before the futures are ready so callers observe them
+    lock.lock();
+    if (commit_error) {
+        this->stats.units_failed += units;
+    } else if (transaction != nullptr) {
+        this->stats.commits++;
+        this->stats.units_committed += units;
+    }
+    this->stats.units_failed += failed;
+    this->stats.largest_group = std::max(this->stats.largest_group, units);
+    lock.unlock();
+
+    for (auto& promise : group) {
+        if (commit_error) {
+            promise.set_exception(commit_error);
+        } else {
+            promise.set_value();
+        }
+    }
+
+    lock.lock();
+}
+
+} // namespace everest::db::sqlite
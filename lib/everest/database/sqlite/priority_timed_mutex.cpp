@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+
+#include <everest/database/sqlite/priority_timed_mutex.hpp>
+
+namespace everest::db::sqlite {
+
+PriorityTimedMutex::PriorityTimedMutex() : locked(false), waiting{}, stats{} {
+}
+
+bool PriorityTimedMutex::can_acquire(TransactionPriority priority) const {
+    if (this->locked) {
+        return false;
+    }
+    const auto index = static_cast<std::size_t>(priority);
+    return std::all_of(this->waiting.begin(), this->waiting.begin() + index, [](auto count) { return count == 0; });
+}
+
+void PriorityTimedMutex::record_wait(TransactionPriority priority, std::chrono::steady_clock::duration wait_time,
+                                     bool acquired) {
+    auto& stats = this->stats.at(static_cast<std::size_t>(priority));
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(wait_time);
+    if (acquired) {
+        stats.acquisitions++;
+    } else {
+        stats.timeouts++;
+    }
+    stats.total_wait_time += wait;
+    stats.max_wait_time = std::max(stats.max_wait_time, wait);
+}
+
+void PriorityTimedMutex::lock() {
+    this->lock(TransactionPriority::Normal);
+}
+
+bool PriorityTimedMutex::try_lock() {
+    const std::lock_guard lock(this->state_mutex);
+    if (this->locked or
+        std::any_of(this->waiting.begin(), this->waiting.end(), [](auto count) { return count != 0; })) {
+        return false;
+    }
+    this->locked = true;
+    return true;
+}
+
+bool PriorityTimedMutex::lock(TransactionPriority priority,
+                              const std::optional<std::chrono::steady_clock::time_point>& deadline) {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock lock(this->state_mutex);
+    if (this->can_acquire(priority)) {
+        this->locked = true;
+        this->record_wait(priority, {}, true);
+        return true;
+    }
+
+    auto& waiting = this->waiting.at(static_cast<std::size_t>(priority));
+    waiting++;
+    const auto admitted = [this, priority]() { return this->can_acquire(priority); };
+    bool acquired = true;
+    if (deadline.has_value()) {
+        acquired = this->state_changed.wait_until(lock, deadline.value(), admitted);
+    } else {
+        this->state_changed.wait(lock, admitted);
+    }
+    waiting--;
+    if (acquired) {
+        this->locked = true;
+    } else {
+        // Lower priority waiters may have been held back by this one
+        this->state_changed.notify_all();
+    }
+    this->record_wait(priority, std::chrono::steady_clock::now() - start, acquired);
+    return acquired;
+}
+
+void PriorityTimedMutex::unlock() {
+    {
+        const std::lock_guard lock(this->state_mutex);
+        this->locked = false;
+    }
+    // Only waiters of the highest waiting priority can proceed, but a single notification might wake a lower one
+    this->state_changed.notify_all();
+}
+
+TransactionLockStats PriorityTimedMutex::get_stats() {
+    const std::lock_guard lock(this->state_mutex);
+    return {this->stats.at(0), this->stats.at(1), this->stats.at(2)};
+}
+
+} // namespace everest::db::sqlite
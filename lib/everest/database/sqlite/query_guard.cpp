@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <iterator>
+#include <vector>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <everest/database/sqlite/query_guard.hpp>
+#include <everest/logging.hpp>
+
+namespace everest::db::sqlite {
+
+namespace {
+std::optional<std::chrono::steady_clock::time_point> deadline_after(std::optional<std::chrono::milliseconds> timeout) {
+    if (!timeout.has_value()) {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::now() + timeout.value();
+}
+
+struct ActiveLimit {
+    const QueryLimiter* limiter;
+    const QueryLimiter::Limit* limit;
+};
+
+/// Limits registered by the current thread, the progress handler runs on the thread stepping the statement
+thread_local std::vector<ActiveLimit> active_limits;
+} // namespace
+
+QueryLimiter::QueryLimiter() : database(nullptr), deadlines_exceeded(0), cancellations(0), interrupts(0) {
+}
+
+QueryLimiter::~QueryLimiter() {
+    this->detach();
+}
+
+void QueryLimiter::attach(sqlite3* db) {
+    // The progress handler never takes database_mutex, so holding it while SQLite takes the connection mutex is safe
+    const std::lock_guard lock(this->database_mutex);
+    this->database = db;
+    sqlite3_progress_handler(db, QUERY_LIMIT_CHECK_INTERVAL, &QueryLimiter::progress_handler, this);
+}
+
+void QueryLimiter::detach() {
+    const std::lock_guard lock(this->database_mutex);
+    if (this->database != nullptr) {
+        sqlite3_progress_handler(this->database, 0, nullptr, nullptr);
+        this->database = nullptr;
+    }
+}
+
+void QueryLimiter::interrupt() {
+    this->interrupts++;
+    const std::lock_guard lock(this->database_mutex);
+    if (this->database != nullptr) {
+        sqlite3_interrupt(this->database);
+    }
+}
+
+void QueryLimiter::set_statement_timeout(std::optional<std::chrono::milliseconds> timeout) {
+    this->statement_timeout = timeout;
+}
+
+std::optional<std::chrono::steady_clock::time_point> QueryLimiter::statement_deadline() const {
+    return deadline_after(this->statement_timeout);
+}
+
+void QueryLimiter::add(const Limit& limit) {
+    active_limits.push_back({this, &limit});
+}
+
+void QueryLimiter::remove(const Limit& limit) {
+    // Guards are scoped, so the limit is usually the last one
+    for (auto it = active_limits.rbegin(); it != active_limits.rend(); ++it) {
+        if (it->limit == &limit) {
+            active_limits.erase(std::next(it).base());
+            return;
+        }
+    }
+}
+
+QueryInterruptStats QueryLimiter::get_stats() const {
+    return {this->deadlines_exceeded.load(), this->cancellations.load(), this->interrupts.load()};
+}
+
+int QueryLimiter::progress_handler(void* context) {
+    if (active_limits.empty()) {
+        return 0;
+    }
+    return static_cast<QueryLimiter*>(context)->check_limits() ? 1 : 0;
+}
+
+bool QueryLimiter::check_limits() {
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& active : active_limits) {
+        if (active.limiter != this) {
+            continue;
+        }
+        const auto& limit = *active.limit;
+        if (limit.cancellation.has_value() and limit.cancellation->is_cancelled()) {
+            this->cancellations++;
+            EVLOG_debug << "Interrupting statement, it was cancelled";
+            return true;
+        }
+        if (limit.deadline.has_value() and now >= limit.deadline.value()) {
+            this->deadlines_exceeded++;
+            EVLOG_warning << "Interrupting statement, its deadline passed";
+            return true;
+        }
+    }
+    return false;
+}
+
+QueryGuard::QueryGuard(Connection& connection, std::chrono::milliseconds timeout) :
+    QueryGuard(connection.query_limiter, {deadline_after(timeout), std::nullopt}) {
+}
+
+QueryGuard::QueryGuard(Connection& connection, const CancellationToken& cancellation,
+                       std::optional<std::chrono::milliseconds> timeout) :
+    QueryGuard(connection.query_limiter, {deadline_after(timeout), cancellation}) {
+}
+
+QueryGuard::QueryGuard(QueryLimiter& limiter, const QueryLimiter::Limit& limit) : limiter(&limiter), limit(limit) {
+    this->limiter->add(this->limit);
+}
+
+QueryGuard::~QueryGuard() {
+    this->limiter->remove(this->limit);
+}
+
+} // namespace everest::db::sqlite
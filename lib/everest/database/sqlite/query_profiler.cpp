@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <mutex>
+
+#include <everest/database/sqlite/query_profiler.hpp>
+#include <everest/logging.hpp>
+
+namespace everest::db::sqlite {
+
+namespace {
+std::size_t latency_bucket(std::int64_t elapsed_ns) {
+    const auto elapsed_us = elapsed_ns / 1000;
+    std::size_t bucket = 0;
+    while (bucket < QUERY_LATENCY_BUCKET_BOUNDS_US.size() and elapsed_us >= QUERY_LATENCY_BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+} // namespace
+
+void QueryProfiler::Entry::record(std::int64_t elapsed_ns) {
+    const auto elapsed = static_cast<std::uint64_t>(elapsed_ns);
+    this->calls.fetch_add(1, std::memory_order_relaxed);
+    this->total_ns.fetch_add(elapsed, std::memory_order_relaxed);
+    this->histogram[latency_bucket(elapsed_ns)].fetch_add(1, std::memory_order_relaxed);
+    auto max = this->max_ns.load(std::memory_order_relaxed);
+    while (elapsed > max and not this->max_ns.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {
+    }
+}
+
+QueryProfiler::QueryProfiler(const QueryProfilerOptions& options) :
+    slow_query_threshold_ns(0), max_queries(0), slow_queries(0), untracked_calls(0) {
+    this->set_options(options);
+}
+
+void QueryProfiler::set_options(const QueryProfilerOptions& options) {
+    this->slow_query_threshold_ns = std::chrono::nanoseconds(options.slow_query_threshold).count();
+    this->max_queries = options.max_queries;
+}
+
+bool QueryProfiler::attach(sqlite3* db) {
+    // Statements that were running when the callback was removed never report their end, and their addresses can be
+    // reused by new statements
+    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+    this->running.clear();
+    if (sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW,
+                         &QueryProfiler::trace_callback, this) != SQLITE_OK) {
+        EVLOG_error << "Could not register query profiler: " << sqlite3_errmsg(db);
+        return false;
+    }
+    return true;
+}
+
+void QueryProfiler::detach(sqlite3* db) {
+    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+}
+
+int QueryProfiler::trace_callback(unsigned int type, void* context, void* p, void* x) {
+    auto* profiler = static_cast<QueryProfiler*>(context);
+    if (type == SQLITE_TRACE_STMT) {
+        profiler->on_statement(static_cast<sqlite3_stmt*>(p));
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        profiler->on_profile(static_cast<sqlite3_stmt*>(p), *static_cast<sqlite3_int64*>(x));
+    } else if (type == SQLITE_TRACE_ROW) {
+        profiler->on_row(static_cast<sqlite3_stmt*>(p));
+    }
+    return 0;
+}
+
+std::shared_ptr<QueryProfiler::Entry> QueryProfiler::find_entry(std::string_view sql) {
+    {
+        const std::shared_lock lock(this->entries_mutex);
+        const auto it = this->entries.find(sql);
+        if (it != this->entries.end()) {
+            return it->second;
+        }
+    }
+
+    // First execution of this SQL text, checked again since another thread could have added it in between
+    const std::unique_lock lock(this->entries_mutex);
+    auto it = this->entries.find(sql);
+    if (it == this->entries.end()) {
+        if (this->entries.size() >= this->max_queries.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        auto entry = std::make_shared<Entry>(std::string{sql});
+        const std::string_view key{entry->sql};
+        it = this->entries.emplace(key, std::move(entry)).first;
+    }
+    return it->second;
+}
+
+std::vector<QueryProfiler::RunningStatement>::iterator QueryProfiler::find_running(sqlite3_stmt* stmt) {
+    // Only a few statements of a connection run at the same time, e.g. the outer statement of a nested loop
+    return std::find_if(this->running.begin(), this->running.end(),
+                        [stmt](const RunningStatement& running) { return running.stmt == stmt; });
+}
+
+void QueryProfiler::on_statement(sqlite3_stmt* stmt) {
+    // Also reported for every trigger program the statement runs
+    const char* sql = sqlite3_sql(stmt);
+    if (sql != nullptr and this->find_running(stmt) == this->running.end()) {
+        this->running.push_back({stmt, this->find_entry(sql), std::chrono::steady_clock::now()});
+    }
+}
+
+void QueryProfiler::on_profile(sqlite3_stmt* stmt, std::int64_t elapsed_ns) {
+    std::shared_ptr<Entry> entry;
+    const auto it = this->find_running(stmt);
+    if (it != this->running.end()) {
+        const auto elapsed = std::chrono::steady_clock::now() - it->started;
+        elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        entry = std::move(it->entry);
+        *it = std::move(this->running.back());
+        this->running.pop_back();
+    } else {
+        // Started before the profiler was attached, only the time measured by SQLite is known
+        const char* sql = sqlite3_sql(stmt);
+        if (sql == nullptr) {
+            return;
+        }
+        entry = this->find_entry(sql);
+    }
+
+    const auto threshold = this->slow_query_threshold_ns.load(std::memory_order_relaxed);
+    if (threshold > 0 and elapsed_ns >= threshold) {
+        this->slow_queries++;
+        char* expanded = sqlite3_expanded_sql(stmt);
+        EVLOG_warning << "Slow query (" << elapsed_ns / 1000 << " us): "
+                      << (expanded != nullptr ? expanded : sqlite3_sql(stmt));
+        sqlite3_free(expanded);
+    }
+
+    if (entry != nullptr) {
+        entry->record(elapsed_ns);
+    } else {
+        this->untracked_calls++;
+    }
+}
+
+void QueryProfiler::on_row(sqlite3_stmt* stmt) {
+    const auto it = this->find_running(stmt);
+    if (it != this->running.end() and it->entry != nullptr) {
+        it->entry->rows.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QueryProfile QueryProfiler::snapshot(bool reset) {
+    QueryProfile profile;
+    {
+        const std::unique_lock lock(this->entries_mutex);
+        profile.queries.reserve(this->entries.size());
+        for (const auto& [key, entry] : this->entries) {
+            QueryStats stats;
+            stats.sql = entry->sql;
+            stats.calls = entry->calls.load();
+            stats.rows = entry->rows.load();
+            stats.total_time = std::chrono::nanoseconds(entry->total_ns.load());
+            stats.max_time = std::chrono::nanoseconds(entry->max_ns.load());
+            for (std::size_t i = 0; i < QUERY_LATENCY_BUCKETS; i++) {
+                stats.latency_histogram[i] = entry->histogram[i].load();
+            }
+            profile.queries.push_back(std::move(stats));
+        }
+        if (reset) {
+            this->entries.clear();
+        }
+    }
+    profile.slow_queries = reset ? this->slow_queries.exchange(0) : this->slow_queries.load();
+    profile.untracked_calls = reset ? this->untracked_calls.exchange(0) : this->untracked_calls.load();
+
+    std::sort(profile.queries.begin(), profile.queries.end(),
+              [](const QueryStats& lhs, const QueryStats& rhs) { return lhs.total_time > rhs.total_time; });
+    return profile;
+}
+
+} // namespace everest::db::sqlite
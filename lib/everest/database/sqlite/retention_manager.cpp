@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <ctime>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <everest/database/sqlite/helpers.hpp>
+#include <everest/database/sqlite/retention_manager.hpp>
+#include <everest/logging.hpp>
+
+using std::chrono::duration_cast;
+
+namespace everest::db::sqlite {
+
+namespace {
+std::string format_iso8601(std::chrono::system_clock::time_point time) {
+    const auto seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    const auto milliseconds = duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    std::ostringstream text;
+    text << std::put_time(&utc, "%Y-%m-%dT%H:%M:%S") << '.' << std::setw(3) << std::setfill('0') << milliseconds
+         << 'Z';
+    return text.str();
+}
+
+/// \brief Returns the first column of the first result row of \p sql, or nothing if there is no row or it is NULL
+template <typename... Args>
+std::optional<std::int64_t> query_int64(ConnectionInterface& database, const std::string& sql, const Args&... args) {
+    auto statement = database.new_statement(sql);
+    if (bind_values(*statement, 1, std::forward_as_tuple(args...)) != SQLITE_OK) {
+        throw QueryExecutionException(std::string{"Could not bind parameters: "} + database.get_error_message());
+    }
+    const int result = statement->step();
+    if (result == SQLITE_ROW) {
+        if (statement->column_type(0) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        return statement->column_int64(0);
+    }
+    if (result != SQLITE_DONE) {
+        throw QueryExecutionException(std::string{"Could not execute statement: "} + database.get_error_message());
+    }
+    return std::nullopt;
+}
+} // namespace
+
+RetentionManager::RetentionManager(ConnectionInterface* database, const RetentionOptions& options) :
+    database(database), options(options) {
+    // A chunk of width 0 deletes nothing and would be retried forever
+    if (this->options.chunk_size <= 0) {
+        throw std::invalid_argument("Retention chunk size must be positive");
+    }
+}
+
+void RetentionManager::add_rule(const RetentionRule& rule) {
+    if (rule.table.empty()) {
+        throw std::invalid_argument("Retention rule without table");
+    }
+    if (!rule.max_age.has_value() and !rule.max_rows.has_value()) {
+        throw std::invalid_argument("Retention rule for " + rule.table + " has neither max_age nor max_rows");
+    }
+    if (rule.max_rows.has_value() and rule.max_rows.value() < 0) {
+        // A negative OFFSET is treated as no offset, which would delete every row
+        throw std::invalid_argument("Retention rule for " + rule.table + " has a negative max_rows");
+    }
+    if (rule.max_age.has_value() and rule.age_column.empty()) {
+        throw std::invalid_argument("Retention rule for " + rule.table + " has max_age but no age column");
+    }
+    this->rules.push_back(rule);
+}
+
+RetentionResult RetentionManager::run(std::chrono::system_clock::time_point now) {
+    RetentionResult result;
+    for (const auto& rule : this->rules) {
+        const auto rows_before = result.rows_deleted;
+        if (!this->apply_rule(rule, now, result)) {
+            result.cancelled = true;
+            return result;
+        }
+        EVLOG_debug << "Retention deleted " << result.rows_deleted - rows_before << " rows from " << rule.table;
+    }
+    if (!this->vacuum(result)) {
+        result.cancelled = true;
+    }
+    return result;
+}
+
+bool RetentionManager::apply_rule(const RetentionRule& rule, std::chrono::system_clock::time_point now,
+                                  RetentionResult& result) {
+    constexpr auto lowest = std::numeric_limits<std::int64_t>::min();
+    constexpr auto highest = std::numeric_limits<std::int64_t>::max();
+    const auto table = quote_identifier(rule.table);
+
+    if (rule.max_rows.has_value()) {
+        // Everything up to the newest row beyond the limit is deleted
+        const auto last = query_int64(*this->database,
+                                      "SELECT rowid FROM " + table + " ORDER BY rowid DESC LIMIT 1 OFFSET ?",
+                                      rule.max_rows.value());
+        if (last.has_value() and !this->delete_chunks(rule, "", lowest, last.value(), result)) {
+            return false;
+        }
+    }
+
+    if (rule.max_age.has_value()) {
+        const auto cutoff = now - rule.max_age.value();
+        const auto condition = " AND " + quote_identifier(rule.age_column) + " < ?";
+        switch (rule.timestamp_format) {
+        case TimestampFormat::UnixSeconds:
+            return this->delete_chunks(rule, condition, lowest, highest, result,
+                                       duration_cast<std::chrono::seconds>(cutoff.time_since_epoch()).count());
+        case TimestampFormat::UnixMilliseconds:
+            return this->delete_chunks(rule, condition, lowest, highest, result,
+                                       duration_cast<std::chrono::milliseconds>(cutoff.time_since_epoch()).count());
+        case TimestampFormat::Iso8601:
+            return this->delete_chunks(rule, condition, lowest, highest, result, format_iso8601(cutoff));
+        }
+    }
+    return true;
+}
+
+template <typename... Args>
+bool RetentionManager::delete_chunks(const RetentionRule& rule, const std::string& condition, std::int64_t first,
+                                     std::int64_t last, RetentionResult& result, const Args&... args) {
+    const auto table = quote_identifier(rule.table);
+    const auto find_sql = "SELECT MIN(rowid) FROM " + table + " WHERE rowid BETWEEN ? AND ?" + condition;
+    const auto delete_sql = "DELETE FROM " + table + " WHERE rowid BETWEEN ? AND ?" + condition;
+
+    if (this->options.cancellation.is_cancelled()) {
+        return false;
+    }
+
+    auto next = first;
+    while (true) {
+        // Chunks start at the next matching row, so gaps in the rowids don't produce empty chunks
+        const auto begin = query_int64(*this->database, find_sql, next, last, args...);
+        if (!begin.has_value()) {
+            return true;
+        }
+        // last - begin can exceed the range of int64 for negative rowids, but not the range of uint64
+        const auto remaining = static_cast<std::uint64_t>(last) - static_cast<std::uint64_t>(begin.value());
+        const auto end = remaining < static_cast<std::uint64_t>(this->options.chunk_size)
+                             ? last
+                             : begin.value() + this->options.chunk_size - 1;
+
+        auto transaction = this->database->begin_transaction();
+        const auto deleted = this->database->execute(delete_sql, begin.value(), end, args...);
+        transaction->commit();
+        result.rows_deleted += static_cast<std::uint64_t>(deleted.changes);
+        result.chunks++;
+
+        if (end == last) {
+            return true;
+        }
+        next = end + 1;
+        if (!this->yield()) {
+            return false;
+        }
+    }
+}
+
+bool RetentionManager::vacuum(RetentionResult& result) {
+    if (this->options.vacuum_pages_per_step <= 0) {
+        return true;
+    }
+    // 2 is incremental, the other modes don't support PRAGMA incremental_vacuum
+    if (query_int64(*this->database, "PRAGMA auto_vacuum").value_or(0) != 2) {
+        EVLOG_debug << "Database is not in incremental auto_vacuum mode, free pages are kept";
+        return true;
+    }
+
+    const auto step_sql = "PRAGMA incremental_vacuum(" + std::to_string(this->options.vacuum_pages_per_step) + ")";
+    auto free_pages = query_int64(*this->database, "PRAGMA freelist_count").value_or(0);
+    while (free_pages > 0) {
+        if (!this->yield()) {
+            return false;
+        }
+        auto transaction = this->database->begin_transaction();
+        if (!this->database->execute_statement(step_sql)) {
+            throw QueryExecutionException(std::string{"Incremental vacuum failed: "} +
+                                          this->database->get_error_message());
+        }
+        transaction->commit();
+
+        const auto remaining = query_int64(*this->database, "PRAGMA freelist_count").value_or(0);
+        if (remaining >= free_pages) {
+            // Nothing was freed, e.g. because another connection is reading
+            break;
+        }
+        result.pages_vacuumed += static_cast<std::uint64_t>(free_pages - remaining);
+        free_pages = remaining;
+    }
+    return true;
+}
+
+bool RetentionManager::yield() {
+    if (this->options.cancellation.is_cancelled()) {
+        return false;
+    }
+    std::this_thread::sleep_for(this->options.pause_between_chunks);
+    return !this->options.cancellation.is_cancelled();
+}
+
+} // namespace everest::db::sqlite
@@ -9,20 +9,16 @@
 
 namespace everest::db::sqlite {
 
-enum class Direction {
-    Up,
-    Down
-};
-
 struct MigrationFile {
     fs::path path;
     uint32_t version;
-    Direction direction;
+    MigrationDirection direction;
+    std::string_view sql; ///< Set for embedded migrations, otherwise the SQL is read from path
 };
 
 std::ostream& operator<<(std::ostream& os, const MigrationFile& info) {
-    os << "Migration file [" << (info.direction == Direction::Up ? "up" : "down") << "] version " << info.version
-       << ", path: " << info.path.c_str();
+    os << "Migration file [" << (info.direction == MigrationDirection::Up ? "up" : "down") << "] version "
+       << info.version << ", path: " << info.path.c_str();
     return os;
 }
 
@@ -44,7 +40,8 @@ std::vector<MigrationFile> get_migration_file_list(const fs::path& migration_fil
                 // [2] = up or down
                 // [3] = description or empty
                 result.push_back(MigrationFile{path, static_cast<uint32_t>(std::stoul(match[1].str())),
-                                               match[2] == "up" ? Direction::Up : Direction::Down});
+                                               match[2] == "up" ? MigrationDirection::Up : MigrationDirection::Down,
+                                               {}});
             }
         }
     }
@@ -52,8 +49,8 @@ std::vector<MigrationFile> get_migration_file_list(const fs::path& migration_fil
     return result;
 }
 
-void filter_and_sort_migration_file_list(std::vector<MigrationFile>& list, Direction direction, uint32_t min_version,
-                                         uint32_t max_version) {
+void filter_and_sort_migration_file_list(std::vector<MigrationFile>& list, MigrationDirection direction,
+                                         uint32_t min_version, uint32_t max_version) {
     auto filter = [direction, min_version, max_version](const MigrationFile& item) {
         return item.direction != direction or item.version < min_version or item.version > max_version;
     };
@@ -61,7 +58,7 @@ void filter_and_sort_migration_file_list(std::vector<MigrationFile>& list, Direc
     list.erase(std::remove_if(list.begin(), list.end(), filter), list.end());
 
     std::sort(list.begin(), list.end(), [direction](const auto& a, const auto& b) {
-        if (direction == Direction::Up) {
+        if (direction == MigrationDirection::Up) {
             return a.version < b.version;
         }
         return b.version < a.version;
@@ -83,7 +80,7 @@ bool is_migration_file_list_valid(std::vector<MigrationFile>& list, uint32_t max
         return std::tie(a.version, a.direction) < std::tie(b.version, b.direction);
     });
 
-    if (list.at(0).version != 1 or list.at(0).direction != Direction::Up) {
+    if (list.at(0).version != 1 or list.at(0).direction != MigrationDirection::Up) {
         EVLOG_error << "Invalid initial migration file";
         return false;
     }
@@ -92,11 +89,11 @@ bool is_migration_file_list_valid(std::vector<MigrationFile>& list, uint32_t max
         const uint32_t expected_version = (i / 2) + 2;
         const auto& up = list.at(i);
         const auto& down = list.at(i + 1);
-        if (up.version != expected_version || up.direction != Direction::Up) {
+        if (up.version != expected_version || up.direction != MigrationDirection::Up) {
             EVLOG_error << "Expected migration file " << expected_version << "_up.sql but got: " << up.path.filename();
             return false;
         }
-        if (down.version != expected_version || down.direction != Direction::Down) {
+        if (down.version != expected_version || down.direction != MigrationDirection::Down) {
             EVLOG_error << "Expected migration file " << expected_version
                         << "_down.sql but got: " << down.path.filename();
             return false;
@@ -105,11 +102,10 @@ bool is_migration_file_list_valid(std::vector<MigrationFile>& list, uint32_t max
     return true;
 }
 
-std::optional<std::vector<MigrationFile>> get_migration_file_sequence(const fs::path& migration_file_directory,
-                                                                      Direction direction, uint32_t current_version,
+std::optional<std::vector<MigrationFile>> get_migration_file_sequence(std::vector<MigrationFile> list,
+                                                                      MigrationDirection direction,
+                                                                      uint32_t current_version,
                                                                       uint32_t target_version) {
-    auto list = get_migration_file_list(migration_file_directory);
-
     EVLOG_debug << "Migration list:";
 
     for (auto& item : list) {
@@ -132,27 +128,89 @@ std::optional<std::vector<MigrationFile>> get_migration_file_sequence(const fs::
     }
     return list;
 }
+
+bool backup_database(ConnectionInterface* database, const fs::path& backup_file_path, const BackupOptions& options) {
+    EVLOG_info << "Creating backup " << backup_file_path << " before migrating";
+    try {
+        if (!database->backup_to(backup_file_path, options).get()) {
+            EVLOG_error << "Backup before migrating was cancelled";
+            return false;
+        }
+    } catch (const std::exception& e) {
+        EVLOG_error << "Backup before migrating failed: " << e.what();
+        return false;
+    }
+    return true;
+}
+
+/// \brief Copies \p image into \p database if the database is empty
+/// \return The user version of the database afterwards, 0 if the image was not used
+uint32_t restore_initial_database_image(ConnectionInterface* database, const fs::path& image) {
+    if (!fs::is_regular_file(image)) {
+        EVLOG_warning << "Initial database image " << image << " not found, applying all migrations";
+        return 0;
+    }
+
+    auto statement = database->new_statement("SELECT count(*) FROM sqlite_master;");
+    if (statement->step() != SQLITE_ROW or statement->column_int(0) != 0) {
+        EVLOG_warning << "Database at version 0 is not empty, not using the initial database image";
+        return 0;
+    }
+    statement.reset();
+
+    if (!database->restore_from(image)) {
+        EVLOG_warning << "Could not copy initial database image " << image << ", applying all migrations";
+        return 0;
+    }
+
+    const auto version = database->get_user_version();
+    EVLOG_info << "Initialized database from image " << image << " at version " << version;
+    return version;
+}
+
+/// \brief Returns \p database to the empty state it had before restore_initial_database_image(). The image is copied
+/// in outside of the migration transaction, so a failed migration on top of it would otherwise leave the database at
+/// the version of the image.
+void discard_initial_database_image(ConnectionInterface* database) {
+    // Restoring from an empty database replaces all pages, including the user version
+    if (!database->restore_from(":memory:")) {
+        EVLOG_error << "Could not discard the initial database image, the database stays at the version of the image";
+    }
+}
+
 } // namespace
 
 SchemaUpdater::SchemaUpdater(ConnectionInterface* database) noexcept : database(database) {
 }
 
-bool SchemaUpdater::apply_migration_files(const fs::path& migration_file_directory, uint32_t target_schema_version) {
-    if (!fs::is_directory(migration_file_directory)) {
-        EVLOG_error << "Migration files must be in a directory: " << migration_file_directory.c_str();
-        return false;
-    }
+void SchemaUpdater::use_initial_database_image(const fs::path& image) {
+    this->initial_database_image = image;
+}
+
+void SchemaUpdater::backup_before_migration(const fs::path& backup_file_path, const BackupOptions& options) {
+    this->backup_file_path = backup_file_path;
+    this->backup_options = options;
+}
 
+template <typename LoadMigrationFiles>
+bool SchemaUpdater::apply_migrations(uint32_t target_schema_version, LoadMigrationFiles load_migration_files) {
     if (target_schema_version == 0) {
         EVLOG_error << "Migration target_version 0 is invalid";
         return false;
     }
 
     uint32_t current_version = 0;
+    bool existing_database = false;
+    bool image_restored = false;
 
     try {
         this->database->open_connection();
         current_version = this->database->get_user_version();
+        existing_database = current_version != 0;
+        if (!existing_database and this->initial_database_image.has_value()) {
+            current_version = restore_initial_database_image(this->database, this->initial_database_image.value());
+            image_restored = current_version != 0;
+        }
         EVLOG_info << "Target version: " << target_schema_version << ", current version: " << current_version;
     } catch (std::runtime_error& e) {
         EVLOG_error << "Failure during migration file apply: " << e.what();
@@ -165,17 +223,26 @@ bool SchemaUpdater::apply_migration_files(const fs::path& migration_file_directo
         return true;
     }
 
-    Direction direction = Direction::Up;
+    MigrationDirection direction = MigrationDirection::Up;
 
     if (current_version > target_schema_version) {
-        direction = Direction::Down;
+        direction = MigrationDirection::Down;
     }
 
-    auto list =
-        get_migration_file_sequence(migration_file_directory, direction, current_version, target_schema_version);
+    auto list = get_migration_file_sequence(load_migration_files(), direction, current_version, target_schema_version);
 
     if (!list.has_value()) {
         EVLOG_error << "Missing migration files in sequence, no actions performed";
+        if (image_restored) {
+            discard_initial_database_image(this->database);
+        }
+        this->database->close_connection();
+        return false;
+    }
+
+    if (existing_database and this->backup_file_path.has_value() and
+        !backup_database(this->database, this->backup_file_path.value(), this->backup_options)) {
+        EVLOG_error << "Could not create a backup before migrating, no actions performed";
         this->database->close_connection();
         return false;
     }
@@ -185,12 +252,16 @@ bool SchemaUpdater::apply_migration_files(const fs::path& migration_file_directo
         auto transaction = this->database->begin_transaction();
 
         for (const auto& item : list.value()) {
-            const std::ifstream stream{item.path};
-            std::stringstream init_sql;
+            std::string sql{item.sql};
+            if (sql.empty()) {
+                const std::ifstream stream{item.path};
+                std::stringstream init_sql;
 
-            init_sql << stream.rdbuf();
+                init_sql << stream.rdbuf();
+                sql = init_sql.str();
+            }
 
-            if (!this->database->execute_statement(init_sql.str())) {
+            if (!this->database->execute_statement(sql)) {
                 EVLOG_error << "Could not apply migration file " << item.path;
                 throw std::runtime_error("Database access error");
             }
@@ -203,8 +274,42 @@ bool SchemaUpdater::apply_migration_files(const fs::path& migration_file_directo
         retval = false;
     }
 
+    if (!retval and image_restored) {
+        discard_initial_database_image(this->database);
+    }
+
     this->database->close_connection();
     return retval;
 }
 
+bool SchemaUpdater::apply_migration_files(const fs::path& migration_file_directory, uint32_t target_schema_version) {
+    if (!fs::is_directory(migration_file_directory)) {
+        EVLOG_error << "Migration files must be in a directory: " << migration_file_directory.c_str();
+        return false;
+    }
+
+    const auto load_migration_files = [&migration_file_directory]() {
+        return get_migration_file_list(migration_file_directory);
+    };
+    return this->apply_migrations(target_schema_version, load_migration_files);
+}
+
+bool SchemaUpdater::apply_embedded_migrations(const EmbeddedMigration* migrations, std::size_t count,
+                                              uint32_t target_schema_version) {
+    const auto load_migration_files = [migrations, count]() {
+        std::vector<MigrationFile> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto& migration = migrations[i];
+            // Same as empty files in apply_migration_files(), empty migrations don't count
+            if (!migration.sql.empty()) {
+                result.push_back(
+                    MigrationFile{fs::path{migration.name}, migration.version, migration.direction, migration.sql});
+            }
+        }
+        return result;
+    };
+    return this->apply_migrations(target_schema_version, load_migration_files);
+}
+
 } // namespace everest::db::sqlite
@@ -1,21 +1,104 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
 #include <cstddef>
 
 #include <everest/database/exceptions.hpp>
 #include <everest/database/sqlite/helpers.hpp>
+#include <everest/database/sqlite/query_guard.hpp>
 #include <everest/database/sqlite/statement.hpp>
 #include <everest/logging.hpp>
 #include <sqlite3.h>
 
 namespace everest::db::sqlite {
 
-Statement::Statement(sqlite3* db, const std::string& query) : db(db), stmt(nullptr) {
-    if (sqlite3_prepare_v2(db, query.c_str(), clamp_to<int>(query.size()), &this->stmt, nullptr) != SQLITE_OK) {
+namespace {
+using NameIndices = std::vector<std::pair<std::string, int>>;
+
+void sort_by_name(NameIndices& indices) {
+    // Stable so the first of several columns with the same name is found
+    std::stable_sort(indices.begin(), indices.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+}
+
+int find_by_name(const NameIndices& indices, std::string_view name, int not_found) {
+    const auto it = std::lower_bound(indices.begin(), indices.end(), name,
+                                     [](const auto& entry, std::string_view value) { return entry.first < value; });
+    if (it != indices.end() and it->first == name) {
+        return it->second;
+    }
+    return not_found;
+}
+} // namespace
+
+StatementStats StatementInterface::stats(bool /*reset*/) {
+    return {};
+}
+
+int StatementInterface::bind_blob(const int /*idx*/, ByteSpan /*val*/, SQLiteString /*lifetime*/) {
+    return SQLITE_MISUSE;
+}
+
+int StatementInterface::bind_blob(const std::string& /*param*/, ByteSpan /*val*/, SQLiteString /*lifetime*/) {
+    return SQLITE_MISUSE;
+}
+
+int StatementInterface::bind_zeroblob(const int /*idx*/, const std::uint64_t /*size*/) {
+    return SQLITE_MISUSE;
+}
+
+int StatementInterface::bind_zeroblob(const std::string& /*param*/, const std::uint64_t /*size*/) {
+    return SQLITE_MISUSE;
+}
+
+int StatementInterface::parameter_index(std::string_view /*name*/) {
+    return 0;
+}
+
+int StatementInterface::column_index(std::string_view /*name*/) {
+    return -1;
+}
+
+std::string_view StatementInterface::column_text_view(const int /*idx*/) {
+    throw QueryExecutionException("Zero-copy text access is not supported by this statement");
+}
+
+bool StatementInterface::column_text_into(const int idx, std::string& out) {
+    auto value = this->column_text_nullable(idx);
+    if (not value.has_value()) {
+        out.clear();
+        return false;
+    }
+    out.assign(value.value());
+    return true;
+}
+
+ByteSpan StatementInterface::column_blob(const int /*idx*/) {
+    throw QueryExecutionException("Zero-copy BLOB access is not supported by this statement");
+}
+
+Statement::Statement(sqlite3* db, const std::string& query) : Statement(db, query, 0) {
+}
+
+Statement::Statement(sqlite3* db, const std::string& query, unsigned int prepare_flags) :
+    db(db), stmt(nullptr), limiter(nullptr), column_indices_reprepare_count(0) {
+    if (sqlite3_prepare_v3(db, query.c_str(), clamp_to<int>(query.size()), prepare_flags, &this->stmt, nullptr) !=
+        SQLITE_OK) {
         EVLOG_error << sqlite3_errmsg(db);
         throw QueryExecutionException("Could not prepare statement for database.");
     }
+
+    const int parameter_count = sqlite3_bind_parameter_count(this->stmt);
+    for (int i = 1; i <= parameter_count; i++) {
+        // Anonymous "?" parameters have no name
+        const auto name = sqlite3_bind_parameter_name(this->stmt, i);
+        if (name != nullptr) {
+            this->parameter_indices.emplace_back(name, i);
+        }
+    }
+    sort_by_name(this->parameter_indices);
+    this->build_column_indices();
 }
 
 Statement::~Statement() {
@@ -26,30 +109,84 @@ Statement::~Statement() {
     }
 }
 
+void Statement::build_column_indices() {
+    this->column_indices.clear();
+    this->column_indices_reprepare_count = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_REPREPARE, 0);
+    const int column_count = sqlite3_column_count(this->stmt);
+    for (int i = 0; i < column_count; i++) {
+        const auto name = sqlite3_column_name(this->stmt, i);
+        if (name != nullptr) {
+            this->column_indices.emplace_back(name, i);
+        }
+    }
+    sort_by_name(this->column_indices);
+}
+
+int Statement::resolve_parameter(const std::string& param) {
+    const int index = this->parameter_index(param);
+    if (index <= 0) {
+        throw std::out_of_range("Parameter not found in SQL query");
+    }
+    return index;
+}
+
 int Statement::step() {
+    if (this->limiter == nullptr) {
+        return sqlite3_step(this->stmt);
+    }
+    // Not busy means this step starts a new execution
+    if (sqlite3_stmt_busy(this->stmt) == 0) {
+        this->execution_deadline = this->limiter->statement_deadline();
+    }
+    if (!this->execution_deadline.has_value()) {
+        return sqlite3_step(this->stmt);
+    }
+    const QueryGuard guard{*this->limiter, {this->execution_deadline, std::nullopt}};
     return sqlite3_step(this->stmt);
 }
 
+void Statement::set_query_limiter(QueryLimiter* limiter) {
+    this->limiter = limiter;
+}
+
 int Statement::reset() {
     return sqlite3_reset(this->stmt);
 }
 
+int Statement::clear_bindings() {
+    return sqlite3_clear_bindings(this->stmt);
+}
+
 int Statement::changes() {
     // Rows affected by the last INSERT, UPDATE, DELETE
     return sqlite3_changes(this->db);
 }
 
+StatementStats Statement::stats(bool reset) {
+    StatementStats stats;
+    const int reset_flag = reset ? 1 : 0;
+    stats.fullscan_steps = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, reset_flag);
+    stats.sorts = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_SORT, reset_flag);
+    stats.autoindexes = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_AUTOINDEX, reset_flag);
+    stats.vm_steps = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_VM_STEP, reset_flag);
+    stats.reprepares = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_REPREPARE, reset_flag);
+    stats.runs = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_RUN, reset_flag);
+#ifdef SQLITE_STMTSTATUS_FILTER_HIT
+    stats.filter_hits = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_FILTER_HIT, reset_flag);
+    stats.filter_misses = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_FILTER_MISS, reset_flag);
+#endif
+    // Memory usage is a current value and can't be reset
+    stats.memory_used = sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+    return stats;
+}
+
 int Statement::bind_text(const int idx, const std::string& val, SQLiteString lifetime) {
     return sqlite3_bind_text(this->stmt, idx, val.c_str(), clamp_to<int>(val.length()),
                              lifetime == SQLiteString::Static ? SQLITE_STATIC : SQLITE_TRANSIENT);
 }
 
 int Statement::bind_text(const std::string& param, const std::string& val, SQLiteString lifetime) {
-    const int index = sqlite3_bind_parameter_index(this->stmt, param.c_str());
-    if (index <= 0) {
-        throw std::out_of_range("Parameter not found in SQL query");
-    }
-    return bind_text(index, val, lifetime);
+    return bind_text(this->resolve_parameter(param), val, lifetime);
 }
 
 int Statement::bind_int(const int idx, const int val) {
@@ -57,11 +194,7 @@ int Statement::bind_int(const int idx, const int val) {
 }
 
 int Statement::bind_int(const std::string& param, const int val) {
-    const int index = sqlite3_bind_parameter_index(this->stmt, param.c_str());
-    if (index <= 0) {
-        throw std::out_of_range("Parameter not found in SQL query");
-    }
-    return bind_int(index, val);
+    return bind_int(this->resolve_parameter(param), val);
 }
 
 int Statement::bind_int64(const int idx, const int64_t val) {
@@ -69,11 +202,7 @@ int Statement::bind_int64(const int idx, const int64_t val) {
 }
 
 int Statement::bind_int64(const std::string& param, const int64_t val) {
-    const int index = sqlite3_bind_parameter_index(this->stmt, param.c_str());
-    if (index <= 0) {
-        throw std::out_of_range("Parameter not found in SQL query");
-    }
-    return bind_int64(index, val);
+    return bind_int64(this->resolve_parameter(param), val);
 }
 
 int Statement::bind_double(const int idx, const double val) {
@@ -81,11 +210,7 @@ int Statement::bind_double(const int idx, const double val) {
 }
 
 int Statement::bind_double(const std::string& param, const double val) {
-    const int index = sqlite3_bind_parameter_index(this->stmt, param.c_str());
-    if (index <= 0) {
-        throw std::out_of_range("Parameter not found in SQL query");
-    }
-    return bind_double(index, val);
+    return bind_double(this->resolve_parameter(param), val);
 }
 
 int Statement::bind_null(const int idx) {
@@ -93,11 +218,32 @@ int Statement::bind_null(const int idx) {
 }
 
 int Statement::bind_null(const std::string& param) {
-    const int index = sqlite3_bind_parameter_index(this->stmt, param.c_str());
-    if (index <= 0) {
-        throw std::out_of_range("Parameter not found in SQL query");
+    return bind_null(this->resolve_parameter(param));
+}
+
+int Statement::bind_blob(const int idx, ByteSpan val, SQLiteString lifetime) {
+    if (val.data() == nullptr) {
+        // sqlite3_bind_blob64 would bind NULL for a nullptr, an empty span is a zero length BLOB
+        return sqlite3_bind_zeroblob(this->stmt, idx, 0);
     }
-    return bind_null(index);
+    return sqlite3_bind_blob64(this->stmt, idx, val.data(), val.size(),
+                               lifetime == SQLiteString::Static ? SQLITE_STATIC : SQLITE_TRANSIENT);
+}
+
+int Statement::bind_blob(const std::string& param, ByteSpan val, SQLiteString lifetime) {
+    return bind_blob(this->resolve_parameter(param), val, lifetime);
+}
+
+int Statement::bind_zeroblob(const int idx, const std::uint64_t size) {
+    return sqlite3_bind_zeroblob64(this->stmt, idx, size);
+}
+
+int Statement::bind_zeroblob(const std::string& param, const std::uint64_t size) {
+    return bind_zeroblob(this->resolve_parameter(param), size);
+}
+
+int Statement::parameter_index(std::string_view name) {
+    return find_by_name(this->parameter_indices, name, 0);
 }
 
 int Statement::get_number_of_rows() {
@@ -108,50 +254,79 @@ int Statement::column_type(const int idx) {
     return sqlite3_column_type(this->stmt, idx);
 }
 
+int Statement::column_index(std::string_view name) {
+    if (sqlite3_stmt_status(this->stmt, SQLITE_STMTSTATUS_REPREPARE, 0) != this->column_indices_reprepare_count) {
+        // SQLite re-prepares statements after schema changes, which can change the result columns of e.g. SELECT *
+        this->build_column_indices();
+    }
+    return find_by_name(this->column_indices, name, -1);
+}
+
 SqliteVariant Statement::column_variant(const std::string& name) {
     SqliteVariant ret{};
-    const int column_count = sqlite3_column_count(this->stmt);
-    for (int i = 0; i < column_count; ++i) {
-        const auto val = sqlite3_column_name(this->stmt, i);
-        if (val == nullptr) {
-            return ret;
-        }
-        const std::string column_name{val};
-        if (name == column_name) {
-            switch (sqlite3_column_type(this->stmt, i)) {
-            case SQLITE_INTEGER:
-                ret = column_int64(i);
-                break;
-            case SQLITE_FLOAT:
-                ret = column_double(i);
-                break;
-            case SQLITE_BLOB:
-                // For now we will treat blob as text until this feature is needed
-            case SQLITE_TEXT:
-                ret = column_text(i);
-                break;
-            case SQLITE_NULL:
-            default:
-                break;
-            }
-            break;
-        }
+    const int i = this->column_index(name);
+    if (i < 0) {
+        return ret;
+    }
+    switch (sqlite3_column_type(this->stmt, i)) {
+    case SQLITE_INTEGER:
+        ret = column_int64(i);
+        break;
+    case SQLITE_FLOAT:
+        ret = column_double(i);
+        break;
+    case SQLITE_BLOB:
+        // Treated as text to keep the alternatives of SqliteVariant stable, use column_blob_copy() for the bytes
+    case SQLITE_TEXT:
+        ret.emplace<std::string>(column_text_view(i));
+        break;
+    case SQLITE_NULL:
+    default:
+        break;
     }
     return ret;
 }
 
 std::string Statement::column_text(const int idx) {
-    return reinterpret_cast<const char*>(sqlite3_column_text(this->stmt, idx));
+    return std::string{column_text_view(idx)};
 }
 
 std::optional<std::string> Statement::column_text_nullable(const int idx) {
     auto p = sqlite3_column_text(this->stmt, idx);
     if (p != nullptr) {
-        return reinterpret_cast<const char*>(p);
+        // sqlite3_column_bytes must be called after sqlite3_column_text to get the size of the converted value
+        return std::string{reinterpret_cast<const char*>(p),
+                           static_cast<std::size_t>(sqlite3_column_bytes(this->stmt, idx))};
     }
     return std::optional<std::string>{};
 }
 
+std::string_view Statement::column_text_view(const int idx) {
+    auto p = sqlite3_column_text(this->stmt, idx);
+    if (p == nullptr) {
+        return {};
+    }
+    return {reinterpret_cast<const char*>(p), static_cast<std::size_t>(sqlite3_column_bytes(this->stmt, idx))};
+}
+
+bool Statement::column_text_into(const int idx, std::string& out) {
+    auto p = sqlite3_column_text(this->stmt, idx);
+    if (p == nullptr) {
+        out.clear();
+        return false;
+    }
+    out.assign(reinterpret_cast<const char*>(p), static_cast<std::size_t>(sqlite3_column_bytes(this->stmt, idx)));
+    return true;
+}
+
+ByteSpan Statement::column_blob(const int idx) {
+    auto p = sqlite3_column_blob(this->stmt, idx);
+    if (p == nullptr) {
+        return {};
+    }
+    return {static_cast<const std::uint8_t*>(p), static_cast<std::size_t>(sqlite3_column_bytes(this->stmt, idx))};
+}
+
 int Statement::column_int(const int idx) {
     return sqlite3_column_int(this->stmt, idx);
 }
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/statement_cache.hpp>
+
+namespace everest::db::sqlite {
+
+/// \brief Handle forwarding to a cached statement, returns the statement to the cache when destroyed
+class StatementCache::CachedStatement : public StatementInterface {
+private:
+    StatementCache& cache;
+    std::uint64_t generation;
+    std::string sql;
+    std::unique_ptr<Statement> statement;
+
+public:
+    CachedStatement(StatementCache& cache, std::uint64_t generation, std::string sql,
+                    std::unique_ptr<Statement> statement) :
+        cache(cache), generation(generation), sql(std::move(sql)), statement(std::move(statement)) {
+    }
+
+    ~CachedStatement() override {
+        this->cache.release(this->generation, std::move(this->sql), std::move(this->statement));
+    }
+
+    int step() override {
+        return this->statement->step();
+    }
+    int reset() override {
+        return this->statement->reset();
+    }
+    int changes() override {
+        return this->statement->changes();
+    }
+    StatementStats stats(bool reset) override {
+        return this->statement->stats(reset);
+    }
+
+    int bind_text(const int idx, const std::string& val, SQLiteString lifetime) override {
+        return this->statement->bind_text(idx, val, lifetime);
+    }
+    int bind_text(const std::string& param, const std::string& val, SQLiteString lifetime) override {
+        return this->statement->bind_text(param, val, lifetime);
+    }
+    int bind_int(const int idx, const int val) override {
+        return this->statement->bind_int(idx, val);
+    }
+    int bind_int(const std::string& param, const int val) override {
+        return this->statement->bind_int(param, val);
+    }
+    int bind_int64(const int idx, const int64_t val) override {
+        return this->statement->bind_int64(idx, val);
+    }
+    int bind_int64(const std::string& param, const int64_t val) override {
+        return this->statement->bind_int64(param, val);
+    }
+    int bind_double(const int idx, const double val) override {
+        return this->statement->bind_double(idx, val);
+    }
+    int bind_double(const std::string& param, const double val) override {
+        return this->statement->bind_double(param, val);
+    }
+    int bind_null(const int idx) override {
+        return this->statement->bind_null(idx);
+    }
+    int bind_null(const std::string& param) override {
+        return this->statement->bind_null(param);
+    }
+    int bind_blob(const int idx, ByteSpan val, SQLiteString lifetime) override {
+        return this->statement->bind_blob(idx, val, lifetime);
+    }
+    int bind_blob(const std::string& param, ByteSpan val, SQLiteString lifetime) override {
+        return this->statement->bind_blob(param, val, lifetime);
+    }
+    int bind_zeroblob(const int idx, const std::uint64_t size) override {
+        return this->statement->bind_zeroblob(idx, size);
+    }
+    int bind_zeroblob(const std::string& param, const std::uint64_t size) override {
+        return this->statement->bind_zeroblob(param, size);
+    }
+    int parameter_index(std::string_view name) override {
+        return this->statement->parameter_index(name);
+    }
+
+    int get_number_of_rows() override {
+        return this->statement->get_number_of_rows();
+    }
+    int column_index(std::string_view name) override {
+        return this->statement->column_index(name);
+    }
+    int column_type(const int idx) override {
+        return this->statement->column_type(idx);
+    }
+    SqliteVariant column_variant(const std::string& name) override {
+        return this->statement->column_variant(name);
+    }
+    std::string column_text(const int idx) override {
+        return this->statement->column_text(idx);
+    }
+    std::optional<std::string> column_text_nullable(const int idx) override {
+        return this->statement->column_text_nullable(idx);
+    }
+    std::string_view column_text_view(const int idx) override {
+        return this->statement->column_text_view(idx);
+    }
+    bool column_text_into(const int idx, std::string& out) override {
+        return this->statement->column_text_into(idx, out);
+    }
+    ByteSpan column_blob(const int idx) override {
+        return this->statement->column_blob(idx);
+    }
+    int column_int(const int idx) override {
+        return this->statement->column_int(idx);
+    }
+    int64_t column_int64(const int idx) override {
+        return this->statement->column_int64(idx);
+    }
+    double column_double(const int idx) override {
+        return this->statement->column_double(idx);
+    }
+};
+
+StatementCache::StatementCache(std::size_t capacity) noexcept : capacity(capacity), generation(0) {
+    this->stats.capacity = capacity;
+}
+
+StatementCache::~StatementCache() {
+    this->clear();
+}
+
+std::unique_ptr<StatementInterface> StatementCache::acquire(sqlite3* db, const std::string& sql,
+                                                            QueryLimiter* limiter) {
+    std::uint64_t current_generation = 0;
+    {
+        const std::lock_guard lock(this->mutex);
+        if (this->capacity == 0) {
+            this->stats.misses++;
+            auto statement = std::make_unique<Statement>(db, sql);
+            statement->set_query_limiter(limiter);
+            return statement;
+        }
+
+        current_generation = this->generation;
+        const auto it = this->index.find(sql);
+        if (it != this->index.end()) {
+            this->stats.hits++;
+            auto statement = std::move(it->second->second);
+            this->entries.erase(it->second);
+            this->index.erase(it);
+            this->stats.size = this->entries.size();
+            statement->set_query_limiter(limiter);
+            return std::make_unique<CachedStatement>(*this, current_generation, sql, std::move(statement));
+        }
+        this->stats.misses++;
+    }
+
+    // Prepare outside of the lock, parsing is the expensive part we want to keep concurrent
+    auto statement = std::make_unique<Statement>(db, sql, SQLITE_PREPARE_PERSISTENT);
+    statement->set_query_limiter(limiter);
+    return std::make_unique<CachedStatement>(*this, current_generation, sql, std::move(statement));
+}
+
+void StatementCache::release(std::uint64_t statement_generation, std::string sql,
+                             std::unique_ptr<Statement> statement) {
+    // Statements are finalized outside of the lock
+    std::unique_ptr<Statement> evicted;
+    const std::lock_guard lock(this->mutex);
+    if (statement_generation != this->generation or this->capacity == 0 or this->index.count(sql) != 0) {
+        evicted = std::move(statement);
+        return;
+    }
+
+    statement->reset();
+    statement->clear_bindings();
+
+    if (this->entries.size() >= this->capacity) {
+        auto& oldest = this->entries.back();
+        this->index.erase(oldest.first);
+        evicted = std::move(oldest.second);
+        this->entries.pop_back();
+        this->stats.evictions++;
+    }
+
+    this->entries.emplace_front(std::move(sql), std::move(statement));
+    this->index.emplace(this->entries.front().first, this->entries.begin());
+    this->stats.size = this->entries.size();
+}
+
+void StatementCache::clear() {
+    std::list<Entry> finalized;
+    const std::lock_guard lock(this->mutex);
+    this->generation++;
+    this->index.clear();
+    finalized.swap(this->entries);
+    this->stats.size = 0;
+}
+
+void StatementCache::set_capacity(std::size_t capacity) {
+    std::list<Entry> evicted;
+    const std::lock_guard lock(this->mutex);
+    this->capacity = capacity;
+    this->stats.capacity = capacity;
+    while (this->entries.size() > capacity) {
+        this->index.erase(this->entries.back().first);
+        evicted.splice(evicted.end(), this->entries, std::prev(this->entries.end()));
+        this->stats.evictions++;
+    }
+    this->stats.size = this->entries.size();
+}
+
+StatementCacheStats StatementCache::get_stats() const {
+    const std::lock_guard lock(this->mutex);
+    return this->stats;
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,2 @@
+PRAGMA foreign_keys = ON;
+CREATE TABLE TEST_TABLE1(FIELD1 TEXT PRIMARY KEY NOT NULL, FIELD2 INT NOT NULL);
@@ -0,0 +1 @@
+DROP TABLE TEST_TABLE2;
@@ -0,0 +1,2 @@
+-- Quotes, semicolons and backslashes survive embedding: '\n'; "quoted"
+CREATE TABLE TEST_TABLE2(FIELD1 TEXT PRIMARY KEY NOT NULL, FIELD2 INT NOT NULL DEFAULT 2);
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/async_connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class AsyncConnectionTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        db = std::make_unique<Connection>("file:async_connection_test?mode=memory&cache=private");
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    std::int64_t count_items() {
+        auto stmt = db->new_statement("SELECT COUNT(*) FROM items;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int64(0);
+    }
+};
+
+TEST_F(AsyncConnectionTest, SubmitReturnsResult) {
+    AsyncConnection async{db.get()};
+    auto user_version = async.submit([](ConnectionInterface& connection) { return connection.get_user_version(); });
+    EXPECT_EQ(user_version.get(), 0);
+}
+
+TEST_F(AsyncConnectionTest, TasksRunInSubmissionOrder) {
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    {
+        AsyncConnection async{db.get()};
+        for (int i = 0; i < 100; i++) {
+            futures.push_back(async.submit([&order, i](ConnectionInterface&) { order.push_back(i); }));
+        }
+    }
+    ASSERT_EQ(order.size(), 100);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(order.at(i), i);
+    }
+}
+
+TEST_F(AsyncConnectionTest, ExceptionsAreDeliveredThroughFuture) {
+    AsyncConnection async{db.get()};
+    auto failed = async.submit([](ConnectionInterface&) -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    // The executor keeps running after a failed task
+    EXPECT_THROW(async.execute("INSERT INTO missing VALUES (?);", 1).get(), QueryExecutionException);
+    EXPECT_EQ(async.execute("INSERT INTO items (name) VALUES (?);", std::string{"item"}).get().changes, 1);
+}
+
+TEST_F(AsyncConnectionTest, TransactionCommitsOrRollsBack) {
+    AsyncConnection async{db.get()};
+    auto committed = async.transaction([](ConnectionInterface& connection) {
+        connection.execute("INSERT INTO items (name) VALUES (?);", "first");
+        return connection.execute("INSERT INTO items (name) VALUES (?);", "second").last_inserted_rowid;
+    });
+    EXPECT_EQ(committed.get(), 2);
+
+    auto rolled_back = async.transaction([](ConnectionInterface& connection) {
+        connection.execute("INSERT INTO items (name) VALUES (?);", "third");
+        throw std::runtime_error("abort");
+    });
+    EXPECT_THROW(rolled_back.get(), std::runtime_error);
+    EXPECT_EQ(count_items(), 2);
+}
+
+TEST_F(AsyncConnectionTest, QueryReturnsTypedRows) {
+    AsyncConnection async{db.get()};
+    for (int i = 1; i <= 3; i++) {
+        async.execute("INSERT INTO items (id, name) VALUES (?, ?);", i, "item" + std::to_string(i));
+    }
+    const auto rows = async.query<std::int64_t, std::string>("SELECT id, name FROM items WHERE id >= ?;", 2).get();
+    ASSERT_EQ(rows.size(), 2);
+    EXPECT_EQ(std::get<0>(rows.at(0)), 2);
+    EXPECT_EQ(std::get<1>(rows.at(1)), "item3");
+}
+
+TEST_F(AsyncConnectionTest, QueueDepthAndWaitTimeAreCounted) {
+    AsyncConnection async{db.get()};
+    std::promise<void> started;
+    std::promise<void> release;
+    auto blocker = async.submit([&started, gate = release.get_future().share()](ConnectionInterface&) {
+        started.set_value();
+        gate.wait();
+    });
+    started.get_future().wait();
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 3; i++) {
+        queued.push_back(async.submit([](ConnectionInterface&) {}));
+    }
+    EXPECT_EQ(async.get_stats().queue_depth, 3);
+    std::this_thread::sleep_for(5ms);
+    release.set_value();
+    for (auto& future : queued) {
+        future.get();
+    }
+
+    const auto stats = async.get_stats();
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_GE(stats.max_queue_depth, 3);
+    EXPECT_GE(stats.tasks_completed, 3);
+    EXPECT_GE(stats.max_wait_time, 5ms);
+    EXPECT_GE(stats.total_wait_time, stats.max_wait_time);
+}
+
+TEST_F(AsyncConnectionTest, ReadNeedsReaderThreads) {
+    AsyncConnection async{db.get()};
+    EXPECT_THROW(async.read([](ReaderLease&) {}), ConnectionException);
+}
+
+TEST(AsyncConnectionPoolTest, ReadsRunOnReaderConnections) {
+    const auto directory = fs::temp_directory_path() / "async_connection_test";
+    fs::remove_all(directory);
+    {
+        ConnectionPool pool{directory / "test.db", 2};
+        ASSERT_TRUE(pool.open_connection());
+        AsyncConnection async{&pool, 2};
+        async.execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);").get();
+        async.execute("INSERT INTO items (name) VALUES (?);", "item").get();
+
+        const auto rows = async.query_reader<std::string>("SELECT name FROM items;").get();
+        ASSERT_EQ(rows.size(), 1);
+        EXPECT_EQ(std::get<0>(rows.at(0)), "item");
+
+        // Reader connections are read-only
+        auto write = async.read([](ReaderLease& reader) {
+            auto statement = reader.new_statement("INSERT INTO items (name) VALUES ('other');");
+            return statement->step();
+        });
+        EXPECT_EQ(write.get(), SQLITE_READONLY);
+        EXPECT_GE(async.get_reader_stats().max_queue_depth, 1);
+        EXPECT_EQ(async.get_reader_stats().queue_depth, 0);
+        pool.close_connection();
+    }
+    fs::remove_all(directory);
+}
+
+TEST(AsyncConnectionPoolTest, QueriesSeeQueuedWrites) {
+    const auto directory = fs::temp_directory_path() / "async_connection_test";
+    fs::remove_all(directory);
+    {
+        ConnectionPool pool{directory / "test.db", 2};
+        ASSERT_TRUE(pool.open_connection());
+        AsyncConnection async{&pool, 2};
+        async.execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);");
+        for (int i = 0; i < 100; i++) {
+            async.execute("INSERT INTO items (name) VALUES (?);", "item");
+        }
+
+        // Not waiting for the writes, query() still runs after them
+        const auto rows = async.query<std::int64_t>("SELECT COUNT(*) FROM items;").get();
+        ASSERT_EQ(rows.size(), 1);
+        EXPECT_EQ(std::get<0>(rows.at(0)), 100);
+        EXPECT_EQ(async.get_reader_stats().tasks_completed, 0);
+        pool.close_connection();
+    }
+    fs::remove_all(directory);
+}
+
+TEST_F(AsyncConnectionTest, QueryReaderNeedsReaderThreads) {
+    AsyncConnection async{db.get()};
+    EXPECT_THROW(async.query_reader<int>("SELECT 1;"), ConnectionException);
+}
+
+} // namespace everest::db::sqlite
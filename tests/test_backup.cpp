@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class BackupTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    fs::path destination;
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "backup_test";
+        fs::remove_all(directory);
+        destination = directory / "backup" / "backup.db";
+        db = std::make_unique<Connection>(directory / "source.db");
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE items (id INTEGER PRIMARY KEY, data BLOB);"));
+        db->set_user_version(7);
+    }
+
+    void TearDown() override {
+        db.reset();
+        fs::remove_all(directory);
+    }
+
+    /// \brief Inserts \p count rows of 4 KiB, so every row needs at least one page
+    void insert_rows(int count) {
+        const std::vector<std::uint8_t> data(4096, 0xAB);
+        auto transaction = db->begin_transaction();
+        for (int i = 0; i < count; i++) {
+            db->execute("INSERT INTO items (data) VALUES (?);", data);
+        }
+        transaction->commit();
+    }
+
+    static int count_rows(const fs::path& path) {
+        Connection backup{path};
+        EXPECT_TRUE(backup.open_connection());
+        auto stmt = backup.new_statement("SELECT COUNT(*) FROM items;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        const auto rows = stmt->column_int(0);
+        stmt.reset();
+        backup.close_connection();
+        return rows;
+    }
+};
+
+TEST_F(BackupTest, CopiesDatabase) {
+    insert_rows(10);
+
+    EXPECT_TRUE(db->backup_to(destination).get());
+
+    EXPECT_EQ(count_rows(destination), 10);
+    Connection backup{destination};
+    ASSERT_TRUE(backup.open_connection());
+    EXPECT_EQ(backup.get_user_version(), 7);
+    EXPECT_FALSE(fs::exists(destination.string() + ".partial"));
+}
+
+TEST_F(BackupTest, CopiesInPacedSteps) {
+    insert_rows(100);
+
+    std::vector<BackupProgress> progress;
+    BackupOptions options;
+    options.pages_per_step = 16;
+    options.pause_between_steps = 0ms;
+    options.on_progress = [&progress](const BackupProgress& step) { progress.push_back(step); };
+
+    EXPECT_TRUE(db->backup_to(destination, options).get());
+
+    ASSERT_GT(progress.size(), 6);
+    EXPECT_GE(progress.front().total_pages, 100);
+    EXPECT_EQ(progress.front().remaining_pages, progress.front().total_pages - 16);
+    EXPECT_EQ(progress.back().remaining_pages, 0);
+    EXPECT_EQ(count_rows(destination), 100);
+}
+
+TEST_F(BackupTest, WritesBetweenStepsAreCopied) {
+    insert_rows(50);
+
+    int steps = 0;
+    BackupOptions options;
+    options.pages_per_step = 4;
+    options.pause_between_steps = 0ms;
+    // The database is not locked between steps, writes through the same connection go into the running backup
+    options.on_progress = [this, &steps](const BackupProgress&) {
+        if (steps++ < 5) {
+            insert_rows(1);
+        }
+    };
+
+    EXPECT_TRUE(db->backup_to(destination, options).get());
+    EXPECT_EQ(count_rows(destination), 55);
+}
+
+TEST_F(BackupTest, CancelKeepsPreviousBackup) {
+    fs::create_directories(destination.parent_path());
+    {
+        std::ofstream previous{destination};
+        previous << "previous backup";
+    }
+
+    BackupOptions options;
+    options.cancellation.cancel();
+    EXPECT_FALSE(db->backup_to(destination, options).get());
+
+    std::ifstream previous{destination};
+    std::string content;
+    std::getline(previous, content);
+    EXPECT_EQ(content, "previous backup");
+    EXPECT_FALSE(fs::exists(destination.string() + ".partial"));
+}
+
+TEST_F(BackupTest, ClosedDatabaseFails) {
+    db->close_connection();
+    EXPECT_THROW(db->backup_to(destination).get(), BackupException);
+}
+
+TEST_F(BackupTest, DestructorCancelsRunningBackup) {
+    insert_rows(50);
+
+    BackupOptions options;
+    options.pages_per_step = 1;
+    options.pause_between_steps = 50ms;
+    auto backup = db->backup_to(destination, options);
+    db.reset();
+
+    EXPECT_FALSE(backup.get());
+    EXPECT_FALSE(fs::exists(destination));
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/batch_writer.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+namespace {
+/// \brief Input iterator reading (int, string) tuples from a stream
+class TupleIterator {
+private:
+    std::istream* stream;
+    std::tuple<int, std::string> row;
+
+    void read() {
+        if (not(*this->stream >> std::get<0>(this->row) >> std::get<1>(this->row))) {
+            this->stream = nullptr;
+        }
+    }
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::tuple<int, std::string>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    explicit TupleIterator(std::istream* stream) : stream(stream) {
+        if (this->stream != nullptr) {
+            this->read();
+        }
+    }
+    reference operator*() const {
+        return this->row;
+    }
+    TupleIterator& operator++() {
+        this->read();
+        return *this;
+    }
+    bool operator!=(const TupleIterator& other) const {
+        return this->stream != other.stream;
+    }
+};
+} // namespace
+
+class BatchWriterTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    using Row = std::tuple<int, std::string, std::optional<double>>;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE meter_values (id INTEGER PRIMARY KEY, tag TEXT, value REAL);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    static std::vector<Row> make_rows(int count) {
+        std::vector<Row> rows;
+        for (int i = 0; i < count; i++) {
+            rows.emplace_back(i, "tag" + std::to_string(i), i % 3 == 0 ? std::nullopt : std::optional<double>{i * 0.5});
+        }
+        return rows;
+    }
+
+    int count_rows() {
+        auto stmt = db->new_statement("SELECT COUNT(*) FROM meter_values;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int(0);
+    }
+
+    void expect_row(int id) {
+        auto stmt = db->new_statement("SELECT tag, value FROM meter_values WHERE id = ?;");
+        stmt->bind_int(1, id);
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_text(0), "tag" + std::to_string(id));
+        if (id % 3 == 0) {
+            EXPECT_EQ(stmt->column_type(1), SQLITE_NULL);
+        } else {
+            EXPECT_DOUBLE_EQ(stmt->column_double(1), id * 0.5);
+        }
+    }
+};
+
+TEST_F(BatchWriterTest, WritesSingleRowStatements) {
+    const auto rows = make_rows(1000);
+    BatchWriter<int, std::string, std::optional<double>> writer{db.get(),
+                                                                 "INSERT INTO meter_values VALUES (?, ?, ?);"};
+    const auto result = writer.write(rows);
+
+    EXPECT_EQ(result.rows, 1000);
+    EXPECT_GT(result.rows_per_second(), 0.0);
+    EXPECT_EQ(count_rows(), 1000);
+    expect_row(0);
+    expect_row(999);
+}
+
+TEST_F(BatchWriterTest, WritesMultiRowChunksAndRemainder) {
+    BatchOptions options;
+    options.multi_row_values = true;
+    options.max_variables = 30; // 10 rows per chunk
+
+    // 25 rows are two full chunks and 5 rows written one by one
+    const auto rows = make_rows(25);
+    BatchWriter<int, std::string, std::optional<double>> writer{
+        db.get(), "INSERT INTO meter_values (id, tag, value) VALUES (?, ?, ?) ON CONFLICT DO NOTHING;", options};
+    const auto result = writer.write(rows);
+
+    EXPECT_EQ(result.rows, 25);
+    EXPECT_EQ(count_rows(), 25);
+    for (int i = 0; i < 25; i++) {
+        expect_row(i);
+    }
+}
+
+TEST_F(BatchWriterTest, AcceptsInputIterators) {
+    BatchOptions options;
+    options.multi_row_values = true;
+    options.max_variables = 6;
+
+    std::istringstream input{"1 a 2 b 3 c 4 d 5 e"};
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE pairs (id INTEGER, name TEXT);"));
+    BatchWriter<int, std::string> writer{db.get(), "INSERT INTO pairs VALUES (?, ?)", options};
+
+    const auto result = writer.write(TupleIterator{&input}, TupleIterator{nullptr});
+    EXPECT_EQ(result.rows, 5);
+
+    auto stmt = db->new_statement("SELECT group_concat(name, '') FROM (SELECT name FROM pairs ORDER BY id);");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_text(0), "abcde");
+}
+
+TEST_F(BatchWriterTest, MaxVariablesIsClampedToConnectionLimit) {
+    const auto limit = db->get_limit(SQLITE_LIMIT_VARIABLE_NUMBER);
+    ASSERT_GT(limit, 0);
+
+    BatchOptions options;
+    options.multi_row_values = true;
+    options.max_variables = limit * 2; // a chunk this large could not be prepared
+
+    const auto rows = make_rows(limit);
+    BatchWriter<int, std::string, std::optional<double>> writer{
+        db.get(), "INSERT INTO meter_values (id, tag, value) VALUES (?, ?, ?);", options};
+    EXPECT_EQ(writer.write(rows).rows, rows.size());
+    EXPECT_EQ(count_rows(), limit);
+}
+
+TEST_F(BatchWriterTest, FailingRowRollsBackEverything) {
+    auto rows = make_rows(100);
+    rows.push_back(rows.front()); // duplicate primary key
+
+    BatchOptions options;
+    options.multi_row_values = true;
+    BatchWriter<int, std::string, std::optional<double>> writer{db.get(),
+                                                                 "INSERT INTO meter_values VALUES (?, ?, ?);", options};
+    EXPECT_THROW(writer.write(rows), QueryExecutionException);
+    EXPECT_EQ(count_rows(), 0);
+
+    // The transaction lock was released
+    auto transaction = db->begin_transaction();
+    transaction->commit();
+}
+
+TEST_F(BatchWriterTest, InvalidTemplateForMultiRowThrows) {
+    BatchOptions options;
+    options.multi_row_values = true;
+    using Writer = BatchWriter<int, std::string>;
+
+    EXPECT_THROW(Writer(db.get(), "UPDATE meter_values SET tag = ? WHERE id = ?", options), QueryExecutionException);
+    EXPECT_THROW(Writer(db.get(), "INSERT INTO meter_values (id, tag) VALUES (?, :tag)", options),
+                 QueryExecutionException);
+    EXPECT_NO_THROW(Writer(db.get(), "UPDATE meter_values SET tag = ? WHERE id = ?"));
+}
+
+TEST(ExpandValuesClauseTest, RepeatsGroup) {
+    EXPECT_EQ(detail::expand_values_clause("INSERT INTO t (a, b) values (?, ?);", 2, 3),
+              "INSERT INTO t (a, b) values (?, ?),(?, ?),(?, ?);");
+    EXPECT_EQ(detail::expand_values_clause("INSERT INTO t VALUES (?, abs(?))", 2, 2),
+              "INSERT INTO t VALUES (?, abs(?)),(?, abs(?))");
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+class BlobStreamTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE firmware (id INTEGER PRIMARY KEY, data BLOB);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    void insert_zeroblob(int id, std::uint64_t size) {
+        auto stmt = db->new_statement("INSERT INTO firmware (id, data) VALUES (?, ?);");
+        stmt->bind_int(1, id);
+        stmt->bind_zeroblob(2, size);
+        ASSERT_EQ(stmt->step(), SQLITE_DONE);
+    }
+};
+
+TEST_F(BlobStreamTest, WriteAndReadInChunks) {
+    constexpr std::size_t size = 4096;
+    constexpr std::size_t chunk = 1000;
+    insert_zeroblob(1, size);
+
+    std::vector<std::uint8_t> payload(size);
+    std::iota(payload.begin(), payload.end(), 0);
+
+    {
+        auto blob = db->open_blob("firmware", "data", 1, true);
+        ASSERT_EQ(blob->size(), size);
+        for (std::size_t offset = 0; offset < size; offset += chunk) {
+            const auto length = std::min(chunk, size - offset);
+            blob->write(offset, ByteSpan{payload.data() + offset, length});
+        }
+    }
+
+    auto blob = db->open_blob("firmware", "data", 1, false);
+    std::vector<std::uint8_t> result;
+    for (std::size_t offset = 0; offset < size; offset += chunk) {
+        const auto part = blob->read(offset, std::min(chunk, size - offset));
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    EXPECT_EQ(result, payload);
+}
+
+TEST_F(BlobStreamTest, OutOfRangeAccessThrows) {
+    insert_zeroblob(1, 8);
+    auto blob = db->open_blob("firmware", "data", 1, true);
+
+    EXPECT_THROW(blob->read(4, 8), QueryExecutionException);
+    const std::vector<std::uint8_t> data(9);
+    EXPECT_THROW(blob->write(0, data), QueryExecutionException);
+}
+
+TEST_F(BlobStreamTest, ReadOnlyStreamCantWrite) {
+    insert_zeroblob(1, 8);
+    auto blob = db->open_blob("firmware", "data", 1, false);
+
+    const std::vector<std::uint8_t> data(4);
+    EXPECT_THROW(blob->write(0, data), QueryExecutionException);
+}
+
+TEST_F(BlobStreamTest, ReopenMovesToOtherRow) {
+    insert_zeroblob(1, 4);
+    insert_zeroblob(2, 8);
+
+    auto blob = db->open_blob("firmware", "data", 1, false);
+    EXPECT_EQ(blob->size(), 4);
+    blob->reopen(2);
+    EXPECT_EQ(blob->size(), 8);
+    EXPECT_THROW(blob->reopen(3), QueryExecutionException);
+}
+
+TEST_F(BlobStreamTest, OpenMissingRowThrows) {
+    EXPECT_THROW(db->open_blob("firmware", "data", 42, false), QueryExecutionException);
+}
+
+} // namespace everest::db::sqlite
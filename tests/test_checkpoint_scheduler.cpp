@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class CheckpointSchedulerTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    fs::path file;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "checkpoint_scheduler_test";
+        fs::remove_all(directory);
+        file = directory / "test.db";
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    static ConnectionOptions with_checkpoints(const CheckpointOptions& checkpoint) {
+        auto options = ConnectionOptions::flash_friendly();
+        options.checkpoint = checkpoint;
+        return options;
+    }
+
+    static void write_rows(Connection& connection, int count) {
+        for (int i = 0; i < count; i++) {
+            connection.execute("INSERT INTO data (payload) VALUES (zeroblob(?));", 2000);
+        }
+    }
+
+    /// \brief Waits up to two seconds for \p condition to become true
+    static bool wait_for(const std::function<bool()>& condition) {
+        for (int i = 0; i < 200; i++) {
+            if (condition()) {
+                return true;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+        return condition();
+    }
+};
+
+TEST_F(CheckpointSchedulerTest, DisabledByDefault) {
+    Connection connection{file, ConnectionOptions::flash_friendly()};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+    const auto stats = connection.get_checkpoint_stats();
+    EXPECT_EQ(stats.passive_checkpoints, 0);
+    EXPECT_EQ(stats.wal_frames, 0);
+    connection.close_connection();
+}
+
+TEST_F(CheckpointSchedulerTest, RequiresWalMode) {
+    CheckpointOptions checkpoint;
+    auto options = with_checkpoints(checkpoint);
+    options.journal_mode = JournalMode::Delete;
+    Connection connection{file, options};
+    EXPECT_FALSE(connection.open_connection());
+}
+
+TEST_F(CheckpointSchedulerTest, CommitsDontCheckpoint) {
+    CheckpointOptions checkpoint;
+    checkpoint.idle_time = 1h;
+    checkpoint.wal_size_limit = 1024 * 1024 * 1024;
+    Connection connection{file, with_checkpoints(checkpoint)};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+
+    // More frames than the automatic checkpoint threshold of 1000 pages
+    write_rows(connection, 1100);
+    const auto stats = connection.get_checkpoint_stats();
+    EXPECT_GT(stats.wal_frames, 1000);
+    EXPECT_EQ(stats.frames_pending, stats.wal_frames);
+    EXPECT_EQ(stats.passive_checkpoints + stats.escalated_checkpoints, 0);
+    connection.close_connection();
+}
+
+TEST_F(CheckpointSchedulerTest, PassiveCheckpointWhenIdle) {
+    CheckpointOptions checkpoint;
+    checkpoint.idle_time = 20ms;
+    Connection connection{file, with_checkpoints(checkpoint)};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+    write_rows(connection, 10);
+
+    EXPECT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().frames_pending == 0; }));
+    const auto stats = connection.get_checkpoint_stats();
+    EXPECT_GE(stats.passive_checkpoints, 1);
+    EXPECT_EQ(stats.escalated_checkpoints, 0);
+    EXPECT_GT(stats.wal_frames, 0);
+    EXPECT_GE(stats.max_duration, stats.last_duration);
+    EXPECT_GE(stats.total_duration, stats.max_duration);
+    connection.close_connection();
+}
+
+TEST_F(CheckpointSchedulerTest, ReaderDelaysCheckpoint) {
+    CheckpointOptions checkpoint;
+    checkpoint.idle_time = 20ms;
+    Connection connection{file, with_checkpoints(checkpoint)};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+    write_rows(connection, 1);
+    ASSERT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().frames_pending == 0; }));
+
+    // Frames committed after a reader started can't be copied while the reader is active
+    Connection reader{file};
+    ASSERT_TRUE(reader.open_connection());
+    ASSERT_TRUE(reader.execute_statement("BEGIN;"));
+    auto select = reader.new_statement("SELECT COUNT(*) FROM data;");
+    ASSERT_EQ(select->step(), SQLITE_ROW);
+    write_rows(connection, 10);
+    ASSERT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().passive_checkpoints >= 2; }));
+    EXPECT_GT(connection.get_checkpoint_stats().frames_pending, 0);
+
+    select.reset();
+    ASSERT_TRUE(reader.execute_statement("COMMIT;"));
+    EXPECT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().frames_pending == 0; }));
+    reader.close_connection();
+    connection.close_connection();
+}
+
+TEST_F(CheckpointSchedulerTest, EscalatesWhenWalReachesLimit) {
+    CheckpointOptions checkpoint;
+    checkpoint.idle_time = 1h;
+    checkpoint.wal_size_limit = 64 * 1024;
+    checkpoint.escalation_mode = CheckpointMode::Truncate;
+    Connection connection{file, with_checkpoints(checkpoint)};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+    write_rows(connection, 50);
+
+    // Commits after the last escalation are left for an idle checkpoint, but the WAL stays below the limit
+    const auto frame_size = 4096 + 24;
+    EXPECT_TRUE(wait_for([&connection, &frame_size]() {
+        return connection.get_checkpoint_stats().wal_frames * frame_size < 64 * 1024;
+    }));
+    const auto stats = connection.get_checkpoint_stats();
+    EXPECT_GE(stats.escalated_checkpoints, 1);
+    EXPECT_EQ(stats.passive_checkpoints, 0);
+    EXPECT_LT(fs::file_size(file.string() + "-wal"), 50 * frame_size);
+    connection.close_connection();
+}
+
+TEST_F(CheckpointSchedulerTest, StatsAreKeptAfterReopen) {
+    CheckpointOptions checkpoint;
+    checkpoint.idle_time = 10ms;
+    Connection connection{file, with_checkpoints(checkpoint)};
+    ASSERT_TRUE(connection.open_connection());
+    ASSERT_TRUE(connection.execute_statement("CREATE TABLE data (id INTEGER PRIMARY KEY, payload BLOB);"));
+    ASSERT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().passive_checkpoints >= 1; }));
+    ASSERT_TRUE(connection.close_connection());
+
+    ASSERT_TRUE(connection.open_connection());
+    write_rows(connection, 1);
+    EXPECT_TRUE(wait_for([&connection]() { return connection.get_checkpoint_stats().passive_checkpoints >= 2; }));
+    connection.close_connection();
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class ConnectionOptionsTest : public ::testing::Test {
+protected:
+    fs::path directory;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "connection_options_test";
+        fs::remove_all(directory);
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    static std::string pragma(Connection& connection, const std::string& name) {
+        auto stmt = connection.new_statement("PRAGMA " + name);
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_text(0);
+    }
+};
+
+TEST_F(ConnectionOptionsTest, FlashFriendlyPresetIsApplied) {
+    Connection connection{directory / "test.db", ConnectionOptions::flash_friendly()};
+    ASSERT_TRUE(connection.open_connection());
+
+    EXPECT_EQ(pragma(connection, "journal_mode"), "wal");
+    EXPECT_EQ(pragma(connection, "synchronous"), "1");
+    EXPECT_EQ(pragma(connection, "temp_store"), "2");
+    EXPECT_EQ(pragma(connection, "cache_size"), "-2048");
+    EXPECT_EQ(pragma(connection, "busy_timeout"), "5000");
+    connection.close_connection();
+}
+
+TEST_F(ConnectionOptionsTest, IndividualOptionsAreApplied) {
+    ConnectionOptions options;
+    options.page_size = 8192;
+    options.journal_mode = JournalMode::Truncate;
+    options.synchronous = SynchronousMode::Full;
+    options.locking_mode = LockingMode::Exclusive;
+    options.busy_timeout = 250ms;
+
+    Connection connection{directory / "test.db", options};
+    ASSERT_TRUE(connection.open_connection());
+
+    EXPECT_EQ(pragma(connection, "page_size"), "8192");
+    EXPECT_EQ(pragma(connection, "journal_mode"), "truncate");
+    EXPECT_EQ(pragma(connection, "synchronous"), "2");
+    EXPECT_EQ(pragma(connection, "locking_mode"), "exclusive");
+    EXPECT_EQ(pragma(connection, "busy_timeout"), "250");
+    connection.close_connection();
+}
+
+TEST_F(ConnectionOptionsTest, InMemoryTestPresetIsApplied) {
+    Connection connection{"file::memory:", ConnectionOptions::in_memory_test()};
+    ASSERT_TRUE(connection.open_connection());
+
+    EXPECT_EQ(pragma(connection, "journal_mode"), "memory");
+    EXPECT_EQ(pragma(connection, "synchronous"), "0");
+    connection.close_connection();
+}
+
+TEST_F(ConnectionOptionsTest, OpenFailsWhenOptionCantBeApplied) {
+    // In-memory databases can't use WAL, the read back journal mode is "memory"
+    ConnectionOptions options;
+    options.journal_mode = JournalMode::Wal;
+
+    Connection connection{"file::memory:", options};
+    EXPECT_FALSE(connection.open_connection());
+}
+
+TEST_F(ConnectionOptionsTest, OpenFlagsArePassedToSqlite) {
+    ConnectionOptions options;
+    options.open_flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_URI;
+
+    fs::create_directories(directory);
+    Connection connection{directory / "missing.db", options};
+    EXPECT_FALSE(connection.open_connection());
+}
+
+TEST_F(ConnectionOptionsTest, StatementCacheCapacityIsApplied) {
+    ConnectionOptions options;
+    options.statement_cache_capacity = 3;
+
+    Connection connection{"file::memory:", options};
+    EXPECT_EQ(connection.get_statement_cache_stats().capacity, 3);
+}
+
+TEST_F(ConnectionOptionsTest, AutoVacuumIsAppliedToNewWalDatabase) {
+    auto options = ConnectionOptions::flash_friendly();
+    options.auto_vacuum = AutoVacuum::Incremental;
+    {
+        Connection connection{directory / "test.db", options};
+        ASSERT_TRUE(connection.open_connection());
+        ASSERT_TRUE(connection.execute_statement("CREATE TABLE t (id INTEGER PRIMARY KEY);"));
+        connection.close_connection();
+    }
+
+    // The mode is stored in the database file
+    Connection connection{directory / "test.db"};
+    ASSERT_TRUE(connection.open_connection());
+    EXPECT_EQ(pragma(connection, "auto_vacuum"), "2");
+    connection.close_connection();
+}
+
+} // namespace everest::db::sqlite
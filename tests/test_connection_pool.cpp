@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection_pool.hpp>
+#include <everest/database/sqlite/schema_updater.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    std::unique_ptr<ConnectionPool> pool;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "connection_pool_test";
+        fs::remove_all(directory);
+        pool = std::make_unique<ConnectionPool>(directory / "test.db", 2);
+        ASSERT_TRUE(pool->open_connection());
+        ASSERT_TRUE(pool->execute_statement("CREATE TABLE test_table (id INTEGER PRIMARY KEY, name TEXT);"));
+    }
+
+    void TearDown() override {
+        pool->close_connection();
+        pool.reset();
+        fs::remove_all(directory);
+    }
+
+    template <typename Reader> int count_rows(Reader& reader) {
+        auto stmt = reader.new_statement("SELECT COUNT(*) FROM test_table;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int(0);
+    }
+};
+
+TEST_F(ConnectionPoolTest, DatabaseIsInWalMode) {
+    auto stmt = pool->new_statement("PRAGMA journal_mode;");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_text(0), "wal");
+}
+
+TEST_F(ConnectionPoolTest, ReaderSeesCommittedWrites) {
+    ASSERT_TRUE(pool->execute_statement("INSERT INTO test_table (id, name) VALUES (1, 'a');"));
+
+    auto reader = pool->acquire_reader();
+    EXPECT_EQ(count_rows(reader), 1);
+}
+
+TEST_F(ConnectionPoolTest, ReaderDoesNotWaitOnOpenWriteTransaction) {
+    auto transaction = pool->begin_transaction();
+    ASSERT_TRUE(pool->execute_statement("INSERT INTO test_table (id, name) VALUES (1, 'a');"));
+
+    // Readers run on other threads while the writer holds its transaction and see the last committed state
+    auto first = std::async(std::launch::async, [this]() {
+        auto reader = pool->acquire_reader();
+        return count_rows(reader);
+    });
+    auto second = std::async(std::launch::async, [this]() {
+        auto reader = pool->acquire_reader();
+        return count_rows(reader);
+    });
+    EXPECT_EQ(first.get(), 0);
+    EXPECT_EQ(second.get(), 0);
+
+    transaction->commit();
+
+    auto reader = pool->acquire_reader();
+    EXPECT_EQ(count_rows(reader), 1);
+}
+
+TEST_F(ConnectionPoolTest, ReadersAreReadOnly) {
+    auto reader = pool->acquire_reader();
+    auto stmt = reader.new_statement("INSERT INTO test_table (id, name) VALUES (1, 'a');");
+    EXPECT_EQ(stmt->step(), SQLITE_READONLY);
+}
+
+TEST_F(ConnectionPoolTest, AcquireBlocksUntilReaderIsReturned) {
+    auto first = pool->acquire_reader();
+    auto second = pool->acquire_reader();
+
+    auto third = std::async(std::launch::async, [this]() {
+        auto reader = pool->acquire_reader();
+        return count_rows(reader);
+    });
+    EXPECT_EQ(third.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+    {
+        auto returned = std::move(first);
+    }
+    EXPECT_EQ(third.get(), 0);
+}
+
+TEST_F(ConnectionPoolTest, ReadSnapshotDoesNotSeeLaterWrites) {
+    ASSERT_TRUE(pool->execute_statement("INSERT INTO test_table (id, name) VALUES (1, 'a');"));
+    auto snapshot = pool->begin_read_snapshot();
+
+    // The writer is not blocked by the snapshot
+    auto transaction = pool->begin_transaction({TransactionPriority::Normal, std::chrono::milliseconds(0)});
+    ASSERT_NE(transaction, nullptr);
+    ASSERT_TRUE(pool->execute_statement("INSERT INTO test_table (id, name) VALUES (2, 'b');"));
+    transaction->commit();
+
+    EXPECT_EQ(count_rows(snapshot), 1);
+    {
+        auto reader = pool->acquire_reader();
+        EXPECT_EQ(count_rows(reader), 2);
+    }
+    EXPECT_EQ(count_rows(snapshot), 1);
+
+    snapshot.end();
+    auto next = pool->begin_read_snapshot();
+    EXPECT_EQ(count_rows(next), 2);
+}
+
+TEST_F(ConnectionPoolTest, ReadSnapshotReturnsReader) {
+    auto first = pool->begin_read_snapshot();
+    {
+        auto second = pool->begin_read_snapshot();
+        auto moved = std::move(second);
+        EXPECT_EQ(count_rows(moved), 0);
+    }
+    // The reader of the destroyed snapshot is available and not inside a read transaction anymore
+    auto reader = pool->acquire_reader();
+    auto stmt = reader.new_statement("BEGIN TRANSACTION;");
+    EXPECT_EQ(stmt->step(), SQLITE_DONE);
+    stmt = reader.new_statement("COMMIT TRANSACTION;");
+    EXPECT_EQ(stmt->step(), SQLITE_DONE);
+}
+
+TEST_F(ConnectionPoolTest, LeasedReaderStaysUsableAfterClose) {
+    ASSERT_TRUE(pool->execute_statement("INSERT INTO test_table (id, name) VALUES (1, 'a'), (2, 'b');"));
+    {
+        auto reader = pool->acquire_reader();
+        auto stmt = reader.new_statement("SELECT name FROM test_table ORDER BY id;");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+
+        // Gives up waiting for the lease, but must not tear down the reader it is still using
+        EXPECT_TRUE(pool->close_connection());
+        EXPECT_EQ(stmt->column_text(0), "a");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_text(0), "b");
+        EXPECT_EQ(stmt->step(), SQLITE_DONE);
+    }
+    EXPECT_THROW(pool->acquire_reader(), ConnectionException);
+
+    ASSERT_TRUE(pool->open_connection());
+    auto reader = pool->acquire_reader();
+    EXPECT_EQ(count_rows(reader), 2);
+}
+
+TEST_F(ConnectionPoolTest, SchemaUpdaterWorksOnPool) {
+    const auto migrations = directory / "migrations";
+    fs::create_directories(migrations);
+    std::ofstream{migrations / "1_up.sql"} << "CREATE TABLE migrated (id INTEGER PRIMARY KEY);";
+
+    SchemaUpdater updater{pool.get()};
+    ASSERT_TRUE(updater.apply_migration_files(migrations, 1));
+    EXPECT_EQ(pool->get_user_version(), 1);
+
+    auto reader = pool->acquire_reader();
+    auto stmt = reader.new_statement("SELECT COUNT(*) FROM migrated;");
+    EXPECT_EQ(stmt->step(), SQLITE_ROW);
+}
+
+TEST(ConnectionPoolOpenTest, InMemoryDatabaseIsRejected) {
+    ConnectionPool pool{"file::memory:?cache=shared", 2};
+    EXPECT_FALSE(pool.open_connection());
+}
+
+/// \brief Implements only the functions ConnectionInterface had before it was extended, like implementations outside
+/// of this library
+class MinimalConnection : public ConnectionInterface {
+private:
+    Connection connection{"file::memory:?cache=shared"};
+
+public:
+    bool open_connection() override {
+        return this->connection.open_connection();
+    }
+    bool close_connection() override {
+        return this->connection.close_connection();
+    }
+    std::unique_ptr<TransactionInterface> begin_transaction() override {
+        return this->connection.begin_transaction();
+    }
+    bool execute_statement(const std::string& statement) override {
+        return this->connection.execute_statement(statement);
+    }
+    std::unique_ptr<StatementInterface> new_statement(const std::string& sql) override {
+        return this->connection.new_statement(sql);
+    }
+    const char* get_error_message() override {
+        return this->connection.get_error_message();
+    }
+    bool clear_table(const std::string& table) override {
+        return this->connection.clear_table(table);
+    }
+    int64_t get_last_inserted_rowid() override {
+        return this->connection.get_last_inserted_rowid();
+    }
+    void set_user_version(uint32_t version) override {
+        this->connection.set_user_version(version);
+    }
+    uint32_t get_user_version() override {
+        return this->connection.get_user_version();
+    }
+};
+
+TEST(ConnectionInterfaceTest, DefaultsForMinimalImplementations) {
+    MinimalConnection connection;
+    ConnectionInterface& database = connection;
+    ASSERT_TRUE(database.open_connection());
+
+    auto transaction = database.begin_transaction(TransactionOptions{});
+    ASSERT_NE(transaction, nullptr);
+    transaction->commit();
+    TransactionOptions immediate;
+    immediate.mode = TransactionMode::Immediate;
+    EXPECT_THROW((void)database.begin_transaction(immediate), QueryExecutionException);
+
+    EXPECT_THROW(database.open_blob("t", "c", 1, false), QueryExecutionException);
+    EXPECT_THROW(database.truncate_tables({"t"}), QueryExecutionException);
+    EXPECT_EQ(database.stats().cache_hits, 0);
+    EXPECT_FALSE(database.restore_from("missing.db"));
+    EXPECT_THROW(database.backup_to("backup.db").get(), BackupException);
+    EXPECT_EQ(database.get_limit(SQLITE_LIMIT_VARIABLE_NUMBER), -1);
+    database.close_connection();
+}
+
+} // namespace everest::db::sqlite
@@ -2,6 +2,7 @@
 // Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
 
 #include "database_testing_utils.hpp"
+#include <embedded_test_migrations.hpp>
 #include <everest/database/sqlite/schema_updater.hpp>
 #include <fstream>
 
@@ -34,6 +35,8 @@ static constexpr MigrationFile migration_file_up_3_valid{
 
 static constexpr MigrationFile migration_file_down_3_valid{"3_down-drop_table.sql", "DROP TABLE TEST_TABLE3;"};
 
+static constexpr MigrationFile migration_file_up_3_invalid{"3_up-add_table.sql", "CREATE TABLE <invalid> TEST_TABLE3;"};
+
 static constexpr MigrationFile migration_file_up_4_valid{
     "4_up-add_table.sql", "CREATE TABLE TEST_TABLE4(FIELD1 TEXT PRIMARY KEY NOT NULL, FIELD2 INT NOT NULL);"};
 
@@ -65,6 +68,17 @@ public:
         std::ofstream stream{this->migration_files_path / file.name};
         stream << file.content;
     }
+
+    /// \brief Creates a database file at \p version from the migration files written so far
+    std::filesystem::path CreateDatabaseImage(uint32_t version) {
+        const auto image = this->migration_files_path / "image" / "initial.db";
+        Connection connection{image};
+        EXPECT_TRUE(connection.open_connection());
+        SchemaUpdater updater{&connection};
+        EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, version));
+        connection.close_connection();
+        return image;
+    }
 };
 
 TEST_F(DatabaseSchemaUpdaterTest, FolderDoesNotExist) {
@@ -310,4 +324,194 @@ TEST_F(DatabaseSchemaUpdaterTest, ApplyMultipleMigrationFilesAtOnceWithFailure)
     this->ExpectUserVersion(1);
 }
 
+TEST_F(DatabaseSchemaUpdaterTest, ApplyEmbeddedMigrations) {
+    const std::array<EmbeddedMigration, 5> migrations{
+        EmbeddedMigration{3, MigrationDirection::Down, migration_file_down_3_valid.name,
+                          migration_file_down_3_valid.content},
+        EmbeddedMigration{1, MigrationDirection::Up, migration_file_up_1_valid.name, migration_file_up_1_valid.content},
+        EmbeddedMigration{2, MigrationDirection::Up, migration_file_up_2_valid.name, migration_file_up_2_valid.content},
+        EmbeddedMigration{2, MigrationDirection::Down, migration_file_down_2_valid.name,
+                          migration_file_down_2_valid.content},
+        EmbeddedMigration{3, MigrationDirection::Up, migration_file_up_3_valid.name, migration_file_up_3_valid.content},
+    };
+
+    SchemaUpdater updater{this->database.get()};
+
+    EXPECT_TRUE(updater.apply_embedded_migrations(migrations, 3));
+    this->ExpectUserVersion(3);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+    EXPECT_TRUE(this->DoesTableExist(table2));
+    EXPECT_TRUE(this->DoesTableExist(table3));
+
+    EXPECT_TRUE(updater.apply_embedded_migrations(migrations, 1));
+    this->ExpectUserVersion(1);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+    EXPECT_FALSE(this->DoesTableExist(table2));
+    EXPECT_FALSE(this->DoesTableExist(table3));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, EmbeddedMigrationsSequenceNotValid) {
+    const std::array<EmbeddedMigration, 2> migrations{
+        EmbeddedMigration{1, MigrationDirection::Up, migration_file_up_1_valid.name, migration_file_up_1_valid.content},
+        EmbeddedMigration{2, MigrationDirection::Up, migration_file_up_2_valid.name, migration_file_up_2_valid.content},
+    };
+
+    SchemaUpdater updater{this->database.get()};
+
+    EXPECT_FALSE(updater.apply_embedded_migrations(migrations, 2));
+    EXPECT_FALSE(updater.apply_embedded_migrations(migrations, 0));
+
+    this->ExpectUserVersion(0);
+    EXPECT_FALSE(this->DoesTableExist(table1)); // Database was not changed
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, ApplyMigrationsEmbeddedByCMake) {
+    static_assert(embedded_test_migrations_target_version == 2);
+    static_assert(embedded_test_migrations.size() == 3);
+
+    SchemaUpdater updater{this->database.get()};
+
+    EXPECT_TRUE(updater.apply_embedded_migrations(embedded_test_migrations, embedded_test_migrations_target_version));
+    this->ExpectUserVersion(2);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+    EXPECT_TRUE(this->DoesTableExist(table2));
+
+    auto statement = this->database->new_statement("INSERT INTO TEST_TABLE2 (FIELD1) VALUES ('a') RETURNING FIELD2;");
+    ASSERT_EQ(statement->step(), SQLITE_ROW);
+    EXPECT_EQ(statement->column_int(0), 2);
+    statement.reset();
+
+    EXPECT_TRUE(updater.apply_embedded_migrations(embedded_test_migrations, 1));
+    this->ExpectUserVersion(1);
+    EXPECT_FALSE(this->DoesTableExist(table2));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, InitialDatabaseImageUsedForNewDatabase) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+    this->WriteMigrationFile(migration_file_up_3_valid);
+    this->WriteMigrationFile(migration_file_down_3_valid);
+    const auto image = this->CreateDatabaseImage(3);
+
+    // The image is at the target version, so not even the (empty) migration folder is read
+    const auto empty_folder = this->migration_files_path / "empty";
+    std::filesystem::create_directories(empty_folder);
+
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(image);
+    EXPECT_TRUE(updater.apply_migration_files(empty_folder, 3));
+    this->ExpectUserVersion(3);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+    EXPECT_TRUE(this->DoesTableExist(table2));
+    EXPECT_TRUE(this->DoesTableExist(table3));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, InitialDatabaseImageMigratedToTarget) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+    this->WriteMigrationFile(migration_file_up_3_valid);
+    this->WriteMigrationFile(migration_file_down_3_valid);
+    const auto image = this->CreateDatabaseImage(2);
+
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(image);
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 3));
+    this->ExpectUserVersion(3);
+    EXPECT_TRUE(this->DoesTableExist(table3));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, InitialDatabaseImageDiscardedWhenMigrationFails) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+    const auto image = this->CreateDatabaseImage(2);
+    this->WriteMigrationFile(migration_file_up_3_invalid);
+    this->WriteMigrationFile(migration_file_down_3_valid);
+
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(image);
+    EXPECT_FALSE(updater.apply_migration_files(this->migration_files_path, 3));
+    this->ExpectUserVersion(0);
+    EXPECT_FALSE(this->DoesTableExist(table1));
+    EXPECT_FALSE(this->DoesTableExist(table2));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, InitialDatabaseImageNotUsedForExistingData) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+    const auto image = this->CreateDatabaseImage(2);
+
+    EXPECT_TRUE(this->database->execute_statement("CREATE TABLE EXISTING_DATA(FIELD1 TEXT);"));
+
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(image);
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 2));
+    this->ExpectUserVersion(2);
+    EXPECT_TRUE(this->DoesTableExist(table2));
+    EXPECT_TRUE(this->DoesTableExist("EXISTING_DATA"));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, MissingInitialDatabaseImageAppliesMigrations) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(this->migration_files_path / "missing.db");
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 1));
+    this->ExpectUserVersion(1);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, InitialDatabaseImageBuiltByCMake) {
+#ifdef TEST_INITIAL_DATABASE_IMAGE
+    SchemaUpdater updater{this->database.get()};
+    updater.use_initial_database_image(TEST_INITIAL_DATABASE_IMAGE);
+    EXPECT_TRUE(updater.apply_embedded_migrations(embedded_test_migrations, embedded_test_migrations_target_version));
+    this->ExpectUserVersion(embedded_test_migrations_target_version);
+    EXPECT_TRUE(this->DoesTableExist(table1));
+    EXPECT_TRUE(this->DoesTableExist(table2));
+#else
+    GTEST_SKIP() << "Built without the sqlite3 shell";
+#endif
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, BackupBeforeMigration) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+    const auto backup = this->migration_files_path / "backup" / "backup.db";
+
+    SchemaUpdater updater{this->database.get()};
+    updater.backup_before_migration(backup);
+
+    // New databases and databases at the target version are not backed up
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 1));
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 1));
+    EXPECT_FALSE(std::filesystem::exists(backup));
+
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 2));
+    this->ExpectUserVersion(2);
+    Connection backup_connection{backup};
+    ASSERT_TRUE(backup_connection.open_connection());
+    EXPECT_EQ(backup_connection.get_user_version(), 1);
+}
+
+TEST_F(DatabaseSchemaUpdaterTest, FailedBackupPreventsMigration) {
+    this->WriteMigrationFile(migration_file_up_1_valid);
+    this->WriteMigrationFile(migration_file_up_2_valid);
+    this->WriteMigrationFile(migration_file_down_2_valid);
+
+    SchemaUpdater updater{this->database.get()};
+    EXPECT_TRUE(updater.apply_migration_files(this->migration_files_path, 1));
+
+    BackupOptions options;
+    options.cancellation.cancel();
+    updater.backup_before_migration(this->migration_files_path / "backup.db", options);
+    EXPECT_FALSE(updater.apply_migration_files(this->migration_files_path, 2));
+    this->ExpectUserVersion(1);
+    EXPECT_FALSE(this->DoesTableExist(table2));
+}
+
 } // namespace everest::db::sqlite
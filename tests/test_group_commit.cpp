@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/group_commit.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class GroupCommitTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE test_table (id INTEGER PRIMARY KEY, value INTEGER);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    int count_rows() {
+        auto stmt = db->new_statement("SELECT COUNT(*) FROM test_table;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int(0);
+    }
+
+    static GroupCommit::Work insert(int value) {
+        return [value](ConnectionInterface& connection) {
+            auto stmt = connection.new_statement("INSERT INTO test_table (value) VALUES (?);");
+            stmt->bind_int(1, value);
+            if (stmt->step() != SQLITE_DONE) {
+                throw std::runtime_error(connection.get_error_message());
+            }
+        };
+    }
+};
+
+TEST_F(GroupCommitTest, UnitsFromManyThreadsAreMerged) {
+    GroupCommit group_commit{db.get(), GroupCommitOptions{20ms, 1000}};
+
+    std::vector<std::future<void>> futures;
+    std::vector<std::thread> threads;
+    std::mutex futures_mutex;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 25; i++) {
+                auto future = group_commit.submit(insert(t * 100 + i));
+                const std::lock_guard lock(futures_mutex);
+                futures.push_back(std::move(future));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    EXPECT_EQ(count_rows(), 100);
+    const auto stats = group_commit.get_stats();
+    EXPECT_EQ(stats.units_committed, 100);
+    EXPECT_LT(stats.commits, 100);
+    EXPECT_GT(stats.largest_group, 1);
+}
+
+TEST_F(GroupCommitTest, FailingUnitIsRolledBackAlone) {
+    GroupCommit group_commit{db.get(), GroupCommitOptions{10s, 3}};
+
+    auto first = group_commit.submit(insert(1));
+    auto failing = group_commit.submit([](ConnectionInterface& connection) {
+        ASSERT_TRUE(connection.execute_statement("INSERT INTO test_table (value) VALUES (2);"));
+        throw std::runtime_error("unit failed");
+    });
+    auto third = group_commit.submit(insert(3));
+    auto fourth = group_commit.submit(insert(4));
+
+    EXPECT_NO_THROW(first.get());
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    EXPECT_NO_THROW(third.get());
+    EXPECT_NO_THROW(fourth.get());
+
+    auto stmt = db->new_statement("SELECT COUNT(*) FROM test_table WHERE value = 2;");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_int(0), 0);
+    EXPECT_EQ(group_commit.get_stats().units_failed, 1);
+}
+
+TEST_F(GroupCommitTest, GroupIsCommittedWhenFull) {
+    GroupCommit group_commit{db.get(), GroupCommitOptions{10s, 2}};
+
+    auto first = group_commit.submit(insert(1));
+    auto second = group_commit.submit(insert(2));
+
+    ASSERT_EQ(second.wait_for(5s), std::future_status::ready);
+    first.get();
+    second.get();
+    EXPECT_EQ(count_rows(), 2);
+}
+
+TEST_F(GroupCommitTest, FlushCommitsOpenGroup) {
+    GroupCommit group_commit{db.get(), GroupCommitOptions{10s, 100}};
+
+    auto unit = group_commit.submit(insert(1));
+    auto flushed = group_commit.flush();
+
+    ASSERT_EQ(flushed.wait_for(5s), std::future_status::ready);
+    unit.get();
+    EXPECT_EQ(count_rows(), 1);
+}
+
+TEST_F(GroupCommitTest, FlushFailsWhenTransactionCantBegin) {
+    // BEGIN of the group fails while a transaction is already open on the connection
+    ASSERT_TRUE(db->execute_statement("BEGIN TRANSACTION;"));
+    {
+        GroupCommit group_commit{db.get(), GroupCommitOptions{10s, 100}};
+
+        auto unit = group_commit.submit(insert(1));
+        auto flushed = group_commit.flush();
+
+        ASSERT_EQ(flushed.wait_for(5s), std::future_status::ready);
+        EXPECT_THROW(unit.get(), QueryExecutionException);
+        EXPECT_THROW(flushed.get(), QueryExecutionException);
+        EXPECT_EQ(group_commit.get_stats().commits, 0);
+        EXPECT_EQ(group_commit.get_stats().units_failed, 1);
+    }
+    ASSERT_TRUE(db->execute_statement("ROLLBACK TRANSACTION;"));
+    EXPECT_EQ(count_rows(), 0);
+}
+
+TEST_F(GroupCommitTest, PendingUnitsAreCommittedOnDestruction) {
+    std::future<void> unit;
+    {
+        GroupCommit group_commit{db.get(), GroupCommitOptions{10s, 100}};
+        unit = group_commit.submit(insert(1));
+    }
+    EXPECT_NO_THROW(unit.get());
+    EXPECT_EQ(count_rows(), 1);
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class InMemorySnapshotTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    fs::path file;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "in_memory_snapshot_test";
+        fs::remove_all(directory);
+        file = directory / "state.db";
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    static ConnectionOptions in_memory(std::chrono::milliseconds flush_interval) {
+        // The file settings of the preset are ignored for the in-memory database
+        auto options = ConnectionOptions::flash_friendly();
+        options.in_memory_snapshot = InMemorySnapshotOptions{flush_interval};
+        return options;
+    }
+
+    /// \brief Counts the rows in the database file, bypassing the in-memory database
+    int rows_in_file() {
+        Connection connection{file};
+        EXPECT_TRUE(connection.open_connection());
+        auto stmt = connection.new_statement("SELECT COUNT(*) FROM sessions;");
+        const auto rows = stmt->step() == SQLITE_ROW ? stmt->column_int(0) : -1;
+        stmt.reset();
+        connection.close_connection();
+        return rows;
+    }
+
+    void create_file(const ConnectionOptions& options, int rows) {
+        Connection connection{file, options};
+        ASSERT_TRUE(connection.open_connection());
+        ASSERT_TRUE(connection.execute_statement("CREATE TABLE sessions (id INTEGER PRIMARY KEY, energy REAL);"));
+        for (int i = 0; i < rows; i++) {
+            connection.execute("INSERT INTO sessions (energy) VALUES (?);", i * 1.5);
+        }
+        connection.close_connection();
+    }
+};
+
+TEST_F(InMemorySnapshotTest, LoadsFileAndWritesSnapshotOnDemand) {
+    create_file({}, 3);
+
+    Connection db{file, in_memory(0ms)};
+    ASSERT_TRUE(db.open_connection());
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 10.0);
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 11.0);
+
+    // Changes only live in memory until the snapshot is written
+    EXPECT_EQ(rows_in_file(), 3);
+    EXPECT_TRUE(db.flush_snapshot());
+    EXPECT_EQ(rows_in_file(), 5);
+    EXPECT_FALSE(fs::exists(file.string() + ".partial"));
+    db.close_connection();
+}
+
+TEST_F(InMemorySnapshotTest, CreatesFileForNewDatabase) {
+    Connection db{file, in_memory(0ms)};
+    ASSERT_TRUE(db.open_connection());
+    EXPECT_FALSE(fs::exists(file));
+    ASSERT_TRUE(db.execute_statement("CREATE TABLE sessions (id INTEGER PRIMARY KEY, energy REAL);"));
+    EXPECT_TRUE(db.close_connection());
+    EXPECT_EQ(rows_in_file(), 0);
+}
+
+TEST_F(InMemorySnapshotTest, WritesSnapshotOnClose) {
+    create_file({}, 1);
+    {
+        Connection db{file, in_memory(0ms)};
+        ASSERT_TRUE(db.open_connection());
+        db.execute("INSERT INTO sessions (energy) VALUES (?);", 10.0);
+    }
+    EXPECT_EQ(rows_in_file(), 2);
+}
+
+TEST_F(InMemorySnapshotTest, WritesSnapshotPeriodically) {
+    create_file({}, 0);
+
+    Connection db{file, in_memory(20ms)};
+    ASSERT_TRUE(db.open_connection());
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 10.0);
+
+    auto rows = 0;
+    for (int i = 0; i < 200 and rows == 0; i++) {
+        std::this_thread::sleep_for(10ms);
+        rows = rows_in_file();
+    }
+    EXPECT_EQ(rows, 1);
+    db.close_connection();
+}
+
+TEST_F(InMemorySnapshotTest, OpenTransactionIsNotWritten) {
+    create_file({}, 0);
+
+    Connection db{file, in_memory(0ms)};
+    ASSERT_TRUE(db.open_connection());
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 10.0);
+    auto transaction = db.begin_transaction();
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 11.0);
+    EXPECT_FALSE(db.flush_snapshot());
+    EXPECT_EQ(rows_in_file(), 0);
+
+    transaction->commit();
+    EXPECT_TRUE(db.flush_snapshot());
+    EXPECT_EQ(rows_in_file(), 2);
+    db.close_connection();
+}
+
+TEST_F(InMemorySnapshotTest, LoadsWalDatabase) {
+    auto options = ConnectionOptions::flash_friendly();
+    create_file(options, 2);
+
+    Connection db{file, in_memory(0ms)};
+    ASSERT_TRUE(db.open_connection());
+    db.execute("INSERT INTO sessions (energy) VALUES (?);", 10.0);
+    EXPECT_TRUE(db.close_connection());
+
+    EXPECT_EQ(rows_in_file(), 3);
+}
+
+TEST_F(InMemorySnapshotTest, NoMutexConnectionIsRejected) {
+    auto options = in_memory(0ms);
+    options.open_flags |= SQLITE_OPEN_NOMUTEX;
+    Connection db{file, options};
+    EXPECT_FALSE(db.open_connection());
+    EXPECT_FALSE(fs::exists(file));
+}
+
+TEST_F(InMemorySnapshotTest, FlushNeedsInMemoryMode) {
+    create_file({}, 0);
+    Connection db{file};
+    ASSERT_TRUE(db.open_connection());
+    EXPECT_FALSE(db.flush_snapshot());
+    db.close_connection();
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+namespace {
+/// \brief Takes many seconds, counting to 500 million through a recursive CTE
+const std::string LONG_QUERY = "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 500000000) "
+                               "SELECT COUNT(*) FROM c;";
+const std::string LONG_INSERT = "INSERT INTO events (id) WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM "
+                                "c WHERE x < 500000000) SELECT x FROM c;";
+} // namespace
+
+class QueryGuardTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void open(const ConnectionOptions& options = {}) {
+        db = std::make_unique<Connection>("file:query_guard_test?mode=memory&cache=private", options);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE events (id INTEGER PRIMARY KEY);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    std::int64_t count_events() {
+        auto stmt = db->new_statement("SELECT COUNT(*) FROM events;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int64(0);
+    }
+};
+
+TEST_F(QueryGuardTest, DeadlineInterruptsStatement) {
+    open();
+    const auto start = std::chrono::steady_clock::now();
+    {
+        QueryGuard guard{*db, 50ms};
+        auto stmt = db->new_statement(LONG_QUERY);
+        EXPECT_EQ(stmt->step(), SQLITE_INTERRUPT);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, 50ms);
+    EXPECT_LT(elapsed, 2s);
+    EXPECT_EQ(db->get_query_interrupt_stats().deadlines_exceeded, 1);
+
+    // Statements after the guard are not limited anymore
+    EXPECT_EQ(count_events(), 0);
+}
+
+TEST_F(QueryGuardTest, ExecuteThrowsQueryInterruptedException) {
+    open();
+    QueryGuard guard{*db, 20ms};
+    EXPECT_THROW(db->execute(LONG_QUERY), QueryInterruptedException);
+}
+
+TEST_F(QueryGuardTest, CancellationInterruptsStatement) {
+    open();
+    CancellationToken cancellation;
+    std::thread canceller([cancellation]() mutable {
+        std::this_thread::sleep_for(30ms);
+        cancellation.cancel();
+    });
+    {
+        QueryGuard guard{*db, cancellation, 10s};
+        auto stmt = db->new_statement(LONG_QUERY);
+        EXPECT_EQ(stmt->step(), SQLITE_INTERRUPT);
+    }
+    canceller.join();
+
+    const auto stats = db->get_query_interrupt_stats();
+    EXPECT_EQ(stats.cancellations, 1);
+    EXPECT_EQ(stats.deadlines_exceeded, 0);
+}
+
+TEST_F(QueryGuardTest, InterruptFromOtherThread) {
+    open();
+    std::atomic_bool done{false};
+    // Interrupts have no effect before the statement started, so repeat until it stopped
+    std::thread interrupter([this, &done]() {
+        while (!done) {
+            std::this_thread::sleep_for(10ms);
+            db->interrupt();
+        }
+    });
+    auto stmt = db->new_statement(LONG_QUERY);
+    EXPECT_EQ(stmt->step(), SQLITE_INTERRUPT);
+    done = true;
+    interrupter.join();
+    EXPECT_GE(db->get_query_interrupt_stats().interrupts, 1);
+}
+
+TEST_F(QueryGuardTest, QueryTimeoutBoundsStatements) {
+    ConnectionOptions options;
+    options.query_timeout = 50ms;
+    open(options);
+
+    {
+        auto transaction = db->begin_transaction();
+        db->execute("INSERT INTO events (id) VALUES (1);");
+        EXPECT_THROW(db->execute(LONG_QUERY), QueryInterruptedException);
+    }
+    EXPECT_EQ(count_events(), 0);
+
+    {
+        // SQLite rolls the transaction back itself when a write is interrupted
+        auto transaction = db->begin_transaction();
+        EXPECT_THROW(db->execute(LONG_INSERT), QueryInterruptedException);
+        EXPECT_THROW(transaction->commit(), QueryExecutionException);
+    }
+    EXPECT_EQ(count_events(), 0);
+
+    // execute_statement() keeps reporting failures as false, the interrupt is visible in the stats
+    EXPECT_FALSE(db->execute_statement(LONG_QUERY));
+    EXPECT_EQ(db->get_query_interrupt_stats().deadlines_exceeded, 3);
+
+    // The deadline counts per statement, a transaction of short statements can take longer
+    auto transaction = db->begin_transaction();
+    db->execute("INSERT INTO events (id) VALUES (2);");
+    std::this_thread::sleep_for(80ms);
+    db->execute("INSERT INTO events (id) VALUES (3);");
+    transaction->commit();
+    EXPECT_EQ(count_events(), 2);
+    EXPECT_EQ(db->get_query_interrupt_stats().deadlines_exceeded, 3);
+}
+
+TEST_F(QueryGuardTest, GuardOnlyAppliesToCreatingThread) {
+    open();
+    QueryGuard guard{*db, 1ms};
+    std::this_thread::sleep_for(5ms);
+
+    // The expired guard of this thread does not interrupt statements of other threads
+    std::thread other([this]() {
+        auto stmt = db->new_statement("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < "
+                                      "100000) SELECT COUNT(*) FROM c;");
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_int64(0), 100000);
+    });
+    other.join();
+    EXPECT_EQ(db->get_query_interrupt_stats().deadlines_exceeded, 0);
+
+    auto stmt = db->new_statement(LONG_QUERY);
+    EXPECT_EQ(stmt->step(), SQLITE_INTERRUPT);
+    EXPECT_EQ(db->get_query_interrupt_stats().deadlines_exceeded, 1);
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class QueryProfilerTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    void insert(int id) {
+        db->execute("INSERT INTO items (id, name) VALUES (?, ?);", id, "item" + std::to_string(id));
+    }
+
+    static const QueryStats* find(const QueryProfile& profile, const std::string& sql) {
+        const auto it = std::find_if(profile.queries.begin(), profile.queries.end(),
+                                     [&sql](const QueryStats& stats) { return stats.sql == sql; });
+        return it == profile.queries.end() ? nullptr : &*it;
+    }
+};
+
+TEST_F(QueryProfilerTest, DisabledByDefault) {
+    insert(1);
+    EXPECT_TRUE(db->get_query_profile().queries.empty());
+}
+
+TEST_F(QueryProfilerTest, CountsCallsAndRowsPerSql) {
+    db->enable_query_profiling();
+    for (int i = 0; i < 10; i++) {
+        insert(i);
+    }
+    for (int i = 0; i < 3; i++) {
+        auto stmt = db->new_statement("SELECT id FROM items;");
+        while (stmt->step() == SQLITE_ROW) {
+        }
+    }
+
+    const auto profile = db->get_query_profile();
+    const auto* inserts = find(profile, "INSERT INTO items (id, name) VALUES (?, ?);");
+    ASSERT_NE(inserts, nullptr);
+    EXPECT_EQ(inserts->calls, 10);
+    EXPECT_EQ(std::accumulate(inserts->latency_histogram.begin(), inserts->latency_histogram.end(), std::uint64_t{0}),
+              10);
+    EXPECT_GE(inserts->total_time, inserts->max_time);
+
+    const auto* selects = find(profile, "SELECT id FROM items;");
+    ASSERT_NE(selects, nullptr);
+    EXPECT_EQ(selects->calls, 3);
+    EXPECT_EQ(selects->rows, 30);
+}
+
+TEST_F(QueryProfilerTest, MeasuresSubMillisecondLatency) {
+    db->enable_query_profiling();
+    for (int i = 0; i < 10; i++) {
+        insert(i);
+    }
+
+    // SQLite's own profile times are whole milliseconds, which rounds these inserts down to 0
+    const auto profile = db->get_query_profile();
+    const auto* inserts = find(profile, "INSERT INTO items (id, name) VALUES (?, ?);");
+    ASSERT_NE(inserts, nullptr);
+    EXPECT_GT(inserts->total_time.count(), 0);
+    EXPECT_GT(inserts->max_time.count(), 0);
+}
+
+TEST_F(QueryProfilerTest, CountsRowsOfInterleavedStatements) {
+    for (int i = 0; i < 4; i++) {
+        insert(i);
+    }
+    db->enable_query_profiling();
+
+    auto outer = db->new_statement("SELECT id FROM items;");
+    while (outer->step() == SQLITE_ROW) {
+        auto inner = db->new_statement("SELECT name FROM items WHERE id <= ?;");
+        inner->bind_int(1, outer->column_int(0));
+        while (inner->step() == SQLITE_ROW) {
+        }
+    }
+    outer.reset();
+
+    const auto profile = db->get_query_profile();
+    const auto* outer_stats = find(profile, "SELECT id FROM items;");
+    ASSERT_NE(outer_stats, nullptr);
+    EXPECT_EQ(outer_stats->calls, 1);
+    EXPECT_EQ(outer_stats->rows, 4);
+    const auto* inner_stats = find(profile, "SELECT name FROM items WHERE id <= ?;");
+    ASSERT_NE(inner_stats, nullptr);
+    EXPECT_EQ(inner_stats->calls, 4);
+    EXPECT_EQ(inner_stats->rows, 1 + 2 + 3 + 4);
+}
+
+TEST_F(QueryProfilerTest, ResetAndDisable) {
+    db->enable_query_profiling();
+    insert(1);
+    EXPECT_EQ(db->get_query_profile(true).queries.size(), 1);
+    EXPECT_TRUE(db->get_query_profile().queries.empty());
+
+    db->disable_query_profiling();
+    insert(2);
+    EXPECT_TRUE(db->get_query_profile().queries.empty());
+}
+
+TEST_F(QueryProfilerTest, SlowQueriesAreCounted) {
+    QueryProfilerOptions options;
+    options.slow_query_threshold = 1us;
+    db->enable_query_profiling(options);
+
+    // A recursive CTE producing many rows takes well above a microsecond
+    auto stmt = db->new_statement("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 100000) "
+                                  "SELECT SUM(x) FROM c;");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    stmt.reset();
+
+    EXPECT_GE(db->get_query_profile().slow_queries, 1);
+}
+
+TEST_F(QueryProfilerTest, MaxQueriesLimitsTrackedSql) {
+    QueryProfilerOptions options;
+    options.max_queries = 1;
+    db->enable_query_profiling(options);
+
+    insert(1);
+    ASSERT_TRUE(db->execute_statement("DELETE FROM items;"));
+
+    const auto profile = db->get_query_profile();
+    EXPECT_EQ(profile.queries.size(), 1);
+    EXPECT_EQ(profile.untracked_calls, 1);
+}
+
+TEST_F(QueryProfilerTest, StaysEnabledAfterReopen) {
+    fs::path directory = fs::temp_directory_path() / "query_profiler_test";
+    fs::remove_all(directory);
+    {
+        Connection connection{directory / "test.db"};
+        connection.enable_query_profiling();
+        ASSERT_TRUE(connection.open_connection());
+        ASSERT_TRUE(connection.execute_statement("CREATE TABLE t (id INTEGER);"));
+        ASSERT_TRUE(connection.close_connection());
+        ASSERT_TRUE(connection.open_connection());
+        connection.execute("INSERT INTO t VALUES (?);", 1);
+        EXPECT_NE(find(connection.get_query_profile(), "INSERT INTO t VALUES (?);"), nullptr);
+        connection.close_connection();
+    }
+    fs::remove_all(directory);
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/retention_manager.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class RetentionManagerTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    std::unique_ptr<Connection> db;
+    RetentionOptions options;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "retention_manager_test";
+        fs::remove_all(directory);
+        ConnectionOptions connection_options;
+        connection_options.auto_vacuum = AutoVacuum::Incremental;
+        db = std::make_unique<Connection>(directory / "test.db", connection_options);
+        ASSERT_TRUE(db->open_connection());
+        options.pause_between_chunks = 0ms;
+    }
+
+    void TearDown() override {
+        db->close_connection();
+        db.reset();
+        fs::remove_all(directory);
+    }
+
+    std::int64_t query(const std::string& sql) {
+        auto stmt = db->new_statement(sql);
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int64(0);
+    }
+
+    void create_meter_values(int rows, std::int64_t now, std::int64_t interval) {
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE meter_values (id INTEGER PRIMARY KEY, timestamp INTEGER, "
+                                          "value REAL, data BLOB);"));
+        auto transaction = db->begin_transaction();
+        // Oldest first, like rows appended over time
+        for (int i = rows - 1; i >= 0; i--) {
+            db->execute("INSERT INTO meter_values (timestamp, value, data) VALUES (?, ?, zeroblob(1000));",
+                        now - i * interval, i * 0.5);
+        }
+        transaction->commit();
+    }
+};
+
+TEST_F(RetentionManagerTest, MaxRowsKeepsNewestRows) {
+    create_meter_values(1000, 0, 1);
+    options.chunk_size = 64;
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, 100});
+
+    const auto result = retention.run();
+    EXPECT_EQ(result.rows_deleted, 900);
+    EXPECT_EQ(result.chunks, 15);
+    EXPECT_FALSE(result.cancelled);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM meter_values;"), 100);
+    EXPECT_EQ(query("SELECT MIN(id) FROM meter_values;"), 901);
+
+    // Nothing left to delete
+    EXPECT_EQ(retention.run().rows_deleted, 0);
+}
+
+TEST_F(RetentionManagerTest, MaxAgeWithUnixTimestamps) {
+    const auto now = std::chrono::system_clock::now();
+    const auto now_seconds = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    create_meter_values(100, now_seconds, 60);
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"meter_values", "timestamp", TimestampFormat::UnixSeconds, 30min, std::nullopt});
+
+    // Rows from more than 30 minutes ago are deleted
+    EXPECT_EQ(retention.run(now).rows_deleted, 69);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM meter_values;"), 31);
+    EXPECT_GE(query("SELECT MIN(timestamp) FROM meter_values;"), now_seconds - 30 * 60);
+}
+
+TEST_F(RetentionManagerTest, MaxAgeWithIso8601Timestamps) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE events (id INTEGER PRIMARY KEY, time TEXT);"));
+    for (const auto& time : {"2025-01-01T00:00:00.000Z", "2025-01-30T23:59:59.999Z", "2025-01-31T00:00:00.000Z",
+                             "2025-02-01T12:00:00.000Z"}) {
+        db->execute("INSERT INTO events (time) VALUES (?);", time);
+    }
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"events", "time", TimestampFormat::Iso8601, std::chrono::hours(24), std::nullopt});
+
+    // 2025-02-01T00:00:00Z
+    const auto now = std::chrono::system_clock::time_point{std::chrono::seconds(1738368000)};
+    EXPECT_EQ(retention.run(now).rows_deleted, 2);
+    EXPECT_EQ(query("SELECT MIN(id) FROM events;"), 3);
+}
+
+TEST_F(RetentionManagerTest, GapsInRowidsDontCreateChunks) {
+    // The table name needs quoting
+    ASSERT_TRUE(
+        db->execute_statement("CREATE TABLE \"message \"\"queue\"\"\" (id INTEGER PRIMARY KEY, message TEXT);"));
+    for (const std::int64_t id : {1LL, 1000000LL, 2000000000000LL, 3000000000000LL}) {
+        db->execute("INSERT INTO \"message \"\"queue\"\"\" (id, message) VALUES (?, 'message');", id);
+    }
+    options.chunk_size = 10;
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"message \"queue\"", "", TimestampFormat::UnixSeconds, std::nullopt, 1});
+
+    const auto result = retention.run();
+    EXPECT_EQ(result.rows_deleted, 3);
+    EXPECT_EQ(result.chunks, 3);
+}
+
+TEST_F(RetentionManagerTest, FreePagesAreVacuumed) {
+    create_meter_values(1000, 0, 1);
+    options.vacuum_pages_per_step = 16;
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, 0});
+
+    const auto pages_before = query("PRAGMA page_count;");
+    const auto result = retention.run();
+    EXPECT_EQ(result.rows_deleted, 1000);
+    EXPECT_GT(result.pages_vacuumed, 200);
+    EXPECT_EQ(query("PRAGMA freelist_count;"), 0);
+    EXPECT_EQ(query("PRAGMA page_count;"), pages_before - static_cast<std::int64_t>(result.pages_vacuumed));
+}
+
+TEST_F(RetentionManagerTest, NegativeRowidsAreChunked) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE events (id INTEGER PRIMARY KEY, timestamp INTEGER);"));
+    for (std::int64_t id = -5; id <= 5; id++) {
+        db->execute("INSERT INTO events (id, timestamp) VALUES (?, 0);", id);
+    }
+    options.chunk_size = 4;
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"events", "timestamp", TimestampFormat::UnixSeconds, std::chrono::seconds(1), std::nullopt});
+
+    // The range of a max_age rule ends at the highest rowid, its distance to -5 does not fit into int64
+    const auto result = retention.run(std::chrono::system_clock::time_point{std::chrono::seconds(10)});
+    EXPECT_EQ(result.rows_deleted, 11);
+    EXPECT_EQ(result.chunks, 3);
+}
+
+TEST_F(RetentionManagerTest, CancellationStopsBeforeFirstChunk) {
+    create_meter_values(100, 0, 1);
+    options.chunk_size = 10;
+    options.cancellation.cancel();
+    RetentionManager retention{db.get(), options};
+    retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, 0});
+
+    const auto result = retention.run();
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_EQ(result.chunks, 0);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM meter_values;"), 100);
+}
+
+TEST_F(RetentionManagerTest, InvalidRulesAreRejected) {
+    RetentionManager retention{db.get(), options};
+    EXPECT_THROW(retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, std::nullopt}),
+                 std::invalid_argument);
+    EXPECT_THROW(retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, 1h, std::nullopt}),
+                 std::invalid_argument);
+    EXPECT_THROW(retention.add_rule({"", "timestamp", TimestampFormat::UnixSeconds, 1h, std::nullopt}),
+                 std::invalid_argument);
+}
+
+TEST_F(RetentionManagerTest, NegativeMaxRowsIsRejected) {
+    RetentionManager retention{db.get(), options};
+    EXPECT_THROW(retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, -1}),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(retention.add_rule({"meter_values", "", TimestampFormat::UnixSeconds, std::nullopt, 0}));
+}
+
+TEST_F(RetentionManagerTest, NonPositiveChunkSizeIsRejected) {
+    options.chunk_size = 0;
+    EXPECT_THROW(RetentionManager(db.get(), options), std::invalid_argument);
+    options.chunk_size = -1;
+    EXPECT_THROW(RetentionManager(db.get(), options), std::invalid_argument);
+}
+
+} // namespace everest::db::sqlite
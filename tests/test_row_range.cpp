@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/exceptions.hpp>
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+class RowRangeTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement(
+            "CREATE TABLE readings (id INTEGER PRIMARY KEY, name TEXT, value REAL, raw BLOB);"
+            "INSERT INTO readings VALUES (1, 'voltage', 230.5, x'0102');"
+            "INSERT INTO readings VALUES (2, 'current', 16, NULL);"
+            "INSERT INTO readings VALUES (3, NULL, 0.25, x'');"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+};
+
+TEST_F(RowRangeTest, DecodesAllRows) {
+    auto stmt = db->new_statement("SELECT id, name, value FROM readings WHERE name IS NOT NULL ORDER BY id;");
+
+    std::vector<std::tuple<std::int64_t, std::string, double>> result;
+    auto rows = stmt->rows<std::int64_t, std::string_view, double>();
+    for (const auto& [id, name, value] : rows) {
+        result.emplace_back(id, std::string(name), value);
+    }
+
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0], std::make_tuple(1, "voltage", 230.5));
+    EXPECT_EQ(result[1], std::make_tuple(2, "current", 16.0));
+    EXPECT_EQ(rows.status(), SQLITE_DONE);
+}
+
+TEST_F(RowRangeTest, NullableColumnsUseOptional) {
+    auto stmt = db->new_statement("SELECT name, raw FROM readings ORDER BY id;");
+
+    std::vector<std::optional<std::string>> names;
+    std::vector<std::optional<std::vector<std::uint8_t>>> raws;
+    for (auto [name, raw] : stmt->rows<std::optional<std::string>, std::optional<std::vector<std::uint8_t>>>()) {
+        names.push_back(std::move(name));
+        raws.push_back(std::move(raw));
+    }
+
+    ASSERT_EQ(names.size(), 3);
+    EXPECT_EQ(names[0], "voltage");
+    EXPECT_EQ(names[2], std::nullopt);
+    EXPECT_EQ(raws[0], (std::vector<std::uint8_t>{0x01, 0x02}));
+    EXPECT_EQ(raws[1], std::nullopt);
+}
+
+TEST_F(RowRangeTest, EmptyResultHasNoRows) {
+    auto stmt = db->new_statement("SELECT id FROM readings WHERE id > 10;");
+    auto rows = stmt->rows<int>();
+
+    EXPECT_EQ(rows.begin(), rows.end());
+    EXPECT_EQ(rows.status(), SQLITE_DONE);
+}
+
+TEST_F(RowRangeTest, ColumnCountMismatchThrows) {
+    auto stmt = db->new_statement("SELECT id, name FROM readings;");
+    auto rows = stmt->rows<int>();
+    EXPECT_THROW(rows.begin(), QueryExecutionException);
+}
+
+TEST_F(RowRangeTest, ColumnTypeMismatchThrows) {
+    auto stmt = db->new_statement("SELECT name FROM readings ORDER BY id;");
+    auto rows = stmt->rows<std::int64_t>();
+    EXPECT_THROW(rows.begin(), QueryExecutionException);
+
+    auto null_stmt = db->new_statement("SELECT name FROM readings WHERE id = 3;");
+    auto null_rows = null_stmt->rows<std::string>();
+    EXPECT_THROW(null_rows.begin(), QueryExecutionException);
+}
+
+TEST_F(RowRangeTest, StepErrorIsReported) {
+    // A table can't be dropped while another statement of the same connection is still reading from it
+    auto stmt = db->new_statement("SELECT id FROM readings;");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    auto drop = db->new_statement("DROP TABLE readings;");
+    auto rows = drop->rows<int>();
+    EXPECT_THROW(rows.begin(), QueryExecutionException);
+    EXPECT_NE(rows.status(), SQLITE_DONE);
+}
+
+TEST_F(RowRangeTest, InterruptThrows) {
+    auto stmt = db->new_statement("SELECT id FROM readings ORDER BY id;");
+    auto rows = stmt->rows<std::int64_t>();
+    auto it = rows.begin();
+    ASSERT_NE(it, rows.end());
+    db->interrupt();
+    EXPECT_THROW(++it, QueryInterruptedException);
+    EXPECT_EQ(rows.status(), SQLITE_INTERRUPT);
+}
+
+} // namespace everest::db::sqlite
@@ -8,6 +8,7 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -196,4 +197,353 @@ TEST_F(SQLiteStatementTest, ResetPreservesPreparedStatement) {
     ASSERT_EQ(stmt->step(), SQLITE_DONE);
 }
 
+TEST_F(SQLiteStatementTest, ColumnTextViewAndInto) {
+    auto insert_stmt = db->new_statement("INSERT INTO test_table (name, value, score) VALUES (?, ?, ?);");
+    insert_stmt->bind_text(1, "view_test");
+    insert_stmt->bind_int(2, 7);
+    insert_stmt->bind_null(3);
+    ASSERT_EQ(insert_stmt->step(), SQLITE_DONE);
+
+    auto select_stmt = db->new_statement("SELECT name, value, score FROM test_table WHERE name = 'view_test';");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+
+    EXPECT_EQ(select_stmt->column_text_view(0), "view_test");
+    EXPECT_EQ(select_stmt->column_text_view(2), "");
+
+    std::string buffer;
+    buffer.reserve(64);
+    const auto capacity = buffer.capacity();
+    EXPECT_TRUE(select_stmt->column_text_into(0, buffer));
+    EXPECT_EQ(buffer, "view_test");
+    EXPECT_EQ(buffer.capacity(), capacity);
+
+    EXPECT_TRUE(select_stmt->column_text_into(1, buffer));
+    EXPECT_EQ(buffer, "7");
+
+    EXPECT_FALSE(select_stmt->column_text_into(2, buffer));
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(SQLiteStatementTest, ColumnTextKeepsEmbeddedNul) {
+    auto select_stmt = db->new_statement("SELECT CAST(X'610062' AS TEXT);");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+
+    EXPECT_EQ(select_stmt->column_text_view(0), std::string_view("a\0b", 3));
+    EXPECT_EQ(select_stmt->column_text(0), std::string("a\0b", 3));
+}
+
+TEST_F(SQLiteStatementTest, ColumnBlobView) {
+    auto select_stmt = db->new_statement("SELECT X'0102FF', NULL;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+
+    const auto blob = select_stmt->column_blob(0);
+    ASSERT_EQ(blob.size(), 3);
+    EXPECT_EQ(blob[0], 0x01);
+    EXPECT_EQ(blob[1], 0x02);
+    EXPECT_EQ(blob[2], 0xFF);
+
+    EXPECT_TRUE(select_stmt->column_blob(1).empty());
+}
+
+TEST_F(SQLiteStatementTest, BindBlobAndReadBack) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE blob_table (id INTEGER PRIMARY KEY, data BLOB);"));
+
+    const std::vector<std::uint8_t> payload{0x00, 0x01, 0x7F, 0x80, 0xFF};
+    auto insert_stmt = db->new_statement("INSERT INTO blob_table (id, data) VALUES (:id, :data);");
+    insert_stmt->bind_int(":id", 1);
+    insert_stmt->bind_blob(":data", payload);
+    ASSERT_EQ(insert_stmt->step(), SQLITE_DONE);
+    ASSERT_EQ(insert_stmt->reset(), SQLITE_OK);
+
+    insert_stmt->bind_int(":id", 2);
+    insert_stmt->bind_blob(":data", std::vector<std::uint8_t>{});
+    ASSERT_EQ(insert_stmt->step(), SQLITE_DONE);
+
+    auto select_stmt = db->new_statement("SELECT data, typeof(data) FROM blob_table ORDER BY id;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_type(0), SQLITE_BLOB);
+    const auto blob = select_stmt->column_blob(0);
+    EXPECT_EQ(std::vector<std::uint8_t>(blob.begin(), blob.end()), payload);
+
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_text(1), "blob");
+    EXPECT_TRUE(select_stmt->column_blob(0).empty());
+}
+
+TEST_F(SQLiteStatementTest, BindZeroBlob) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE blob_table (id INTEGER PRIMARY KEY, data BLOB);"));
+
+    auto insert_stmt = db->new_statement("INSERT INTO blob_table (id, data) VALUES (1, ?);");
+    insert_stmt->bind_zeroblob(1, 16);
+    ASSERT_EQ(insert_stmt->step(), SQLITE_DONE);
+
+    auto select_stmt = db->new_statement("SELECT length(data) FROM blob_table;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_int(0), 16);
+}
+
+TEST_F(SQLiteStatementTest, ColumnBlobCopyByName) {
+    auto select_stmt = db->new_statement("SELECT X'0A0B' AS data, 'text' AS name, NULL AS empty;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+
+    EXPECT_EQ(select_stmt->column_blob_copy("data"), (std::vector<std::uint8_t>{0x0A, 0x0B}));
+    EXPECT_FALSE(select_stmt->column_blob_copy("empty").has_value());
+    EXPECT_FALSE(select_stmt->column_blob_copy("missing").has_value());
+
+    // BLOBs keep being returned as text by column_variant()
+    const auto data = select_stmt->column_variant("data");
+    ASSERT_TRUE(std::holds_alternative<std::string>(data));
+    EXPECT_EQ(std::get<std::string>(data), "\x0A\x0B");
+
+    const auto name = select_stmt->column_variant("name");
+    ASSERT_TRUE(std::holds_alternative<std::string>(name));
+    EXPECT_EQ(std::get<std::string>(name), "text");
+}
+
+TEST_F(SQLiteStatementTest, ParameterHandleBindsByIndex) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE param_table (id INTEGER, name TEXT);"));
+
+    auto insert_stmt = db->new_statement("INSERT INTO param_table (id, name) VALUES (@id, :name);");
+    EXPECT_EQ(insert_stmt->parameter_index("@id"), 1);
+    EXPECT_EQ(insert_stmt->parameter_index(":name"), 2);
+    EXPECT_EQ(insert_stmt->parameter_index(":missing"), 0);
+    EXPECT_THROW(insert_stmt->param(":missing"), std::out_of_range);
+
+    auto id = insert_stmt->param("@id");
+    auto name = insert_stmt->param(":name");
+    EXPECT_EQ(name.index(), 2);
+    for (int i = 0; i < 3; i++) {
+        const std::string value = "name" + std::to_string(i);
+        EXPECT_EQ(id.bind_int(i), SQLITE_OK);
+        EXPECT_EQ(name.bind_text(value, SQLiteString::Transient), SQLITE_OK);
+        ASSERT_EQ(insert_stmt->step(), SQLITE_DONE);
+        insert_stmt->reset();
+    }
+
+    auto select_stmt = db->new_statement("SELECT name FROM param_table WHERE id = 2;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_text(0), "name2");
+}
+
+TEST_F(SQLiteStatementTest, ColumnIndexLookup) {
+    auto select_stmt = db->new_statement("SELECT 1 AS b, 2 AS a, 3 AS b;");
+    EXPECT_EQ(select_stmt->column_index("a"), 1);
+    EXPECT_EQ(select_stmt->column_index("b"), 0);
+    EXPECT_EQ(select_stmt->column_index("c"), -1);
+
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(std::get<int64_t>(select_stmt->column_variant("b")), 1);
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(select_stmt->column_variant("c")));
+}
+
+TEST_F(SQLiteStatementTest, ColumnIndexFollowsSchemaChange) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE schema_table (id INTEGER);"));
+    ASSERT_TRUE(db->execute_statement("INSERT INTO schema_table VALUES (1);"));
+
+    auto select_stmt = db->new_statement("SELECT * FROM schema_table;");
+    EXPECT_EQ(select_stmt->column_index("extra"), -1);
+
+    ASSERT_TRUE(db->execute_statement("ALTER TABLE schema_table ADD COLUMN extra TEXT DEFAULT 'x';"));
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_index("extra"), 1);
+    EXPECT_EQ(std::get<std::string>(select_stmt->column_variant("extra")), "x");
+}
+
+TEST_F(SQLiteStatementTest, ColumnIndexFollowsColumnRename) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE rename_table (id INTEGER, old_name TEXT);"));
+    ASSERT_TRUE(db->execute_statement("INSERT INTO rename_table VALUES (1, 'x');"));
+
+    auto select_stmt = db->new_statement("SELECT * FROM rename_table;");
+    EXPECT_EQ(select_stmt->column_index("old_name"), 1);
+
+    // Same column count, only the names change
+    ASSERT_TRUE(db->execute_statement("ALTER TABLE rename_table RENAME COLUMN old_name TO new_name;"));
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_index("old_name"), -1);
+    EXPECT_EQ(select_stmt->column_index("new_name"), 1);
+}
+
+TEST_F(SQLiteStatementTest, ExecuteBindsArguments) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE execute_table (id INTEGER PRIMARY KEY, name TEXT, value REAL);"));
+
+    const std::string name = "first";
+    auto result = db->execute("INSERT INTO execute_table (name, value) VALUES (?, ?);", name, 1.5);
+    EXPECT_EQ(result.changes, 1);
+    EXPECT_EQ(result.last_inserted_rowid, 1);
+
+    result = db->execute("INSERT INTO execute_table (name, value) VALUES (?, ?);", "second", std::nullopt);
+    EXPECT_EQ(result.last_inserted_rowid, 2);
+
+    result = db->execute("UPDATE execute_table SET value = ? WHERE value IS NULL OR id = ?;", 3, 1);
+    EXPECT_EQ(result.changes, 2);
+
+    auto select_stmt = db->new_statement("SELECT SUM(value) FROM execute_table;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(select_stmt->column_int(0), 6);
+}
+
+TEST_F(SQLiteStatementTest, ExecuteReusesCachedStatement) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE execute_table (id INTEGER PRIMARY KEY);"));
+
+    const auto misses = db->get_statement_cache_stats().misses;
+    for (int i = 0; i < 10; i++) {
+        db->execute("INSERT INTO execute_table (id) VALUES (?);", i);
+    }
+    EXPECT_EQ(db->get_statement_cache_stats().misses, misses + 1);
+}
+
+TEST_F(SQLiteStatementTest, ExecuteThrowsOnFailure) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE execute_table (id INTEGER PRIMARY KEY);"));
+    db->execute("INSERT INTO execute_table (id) VALUES (?);", 1);
+
+    EXPECT_THROW(db->execute("INSERT INTO execute_table (id) VALUES (?);", 1), QueryExecutionException);
+    EXPECT_THROW(db->execute("INSERT INTO missing_table (id) VALUES (?);", 1), QueryExecutionException);
+}
+
+TEST_F(SQLiteStatementTest, StatementStatsShowFullScansAndSorts) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE stats_table (id INTEGER PRIMARY KEY, value INTEGER);"));
+    for (int i = 0; i < 50; i++) {
+        db->execute("INSERT INTO stats_table (value) VALUES (?);", 50 - i);
+    }
+
+    auto scan_stmt = db->new_statement("SELECT id FROM stats_table WHERE value > 10 ORDER BY value;");
+    while (scan_stmt->step() == SQLITE_ROW) {
+    }
+    auto stats = scan_stmt->stats(true);
+    EXPECT_GE(stats.fullscan_steps, 49);
+    EXPECT_EQ(stats.sorts, 1);
+    EXPECT_GT(stats.vm_steps, 0);
+    EXPECT_EQ(stats.runs, 1);
+    EXPECT_GT(stats.memory_used, 0);
+
+    stats = scan_stmt->stats();
+    EXPECT_EQ(stats.fullscan_steps, 0);
+    EXPECT_EQ(stats.sorts, 0);
+
+    auto lookup_stmt = db->new_statement("SELECT value FROM stats_table WHERE id = 7;");
+    ASSERT_EQ(lookup_stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(lookup_stmt->stats().fullscan_steps, 0);
+}
+
+TEST_F(SQLiteStatementTest, ConnectionStatsReportCacheUsage) {
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE stats_table (id INTEGER PRIMARY KEY, value TEXT);"));
+    db->execute("INSERT INTO stats_table (value) VALUES (?);", "value");
+    auto select_stmt = db->new_statement("SELECT value FROM stats_table;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+
+    auto stats = db->stats(true);
+    EXPECT_GT(stats.cache_used, 0);
+    EXPECT_GT(stats.schema_used, 0);
+    EXPECT_GT(stats.statements_used, 0);
+    EXPECT_GT(stats.cache_hits, 0);
+
+    stats = db->stats();
+    EXPECT_EQ(stats.cache_hits, 0);
+    EXPECT_GT(stats.cache_used, 0);
+}
+
+/// \brief Implements only the functions StatementInterface had before it was extended, like implementations outside
+/// of this library
+class MinimalStatement : public StatementInterface {
+private:
+    std::unique_ptr<StatementInterface> statement;
+
+public:
+    explicit MinimalStatement(std::unique_ptr<StatementInterface> statement) : statement(std::move(statement)) {
+    }
+
+    int step() override {
+        return this->statement->step();
+    }
+    int reset() override {
+        return this->statement->reset();
+    }
+    int changes() override {
+        return this->statement->changes();
+    }
+    int bind_text(const int idx, const std::string& val, SQLiteString lifetime) override {
+        return this->statement->bind_text(idx, val, lifetime);
+    }
+    int bind_text(const std::string& param, const std::string& val, SQLiteString lifetime) override {
+        return this->statement->bind_text(param, val, lifetime);
+    }
+    int bind_int(const int idx, const int val) override {
+        return this->statement->bind_int(idx, val);
+    }
+    int bind_int(const std::string& param, const int val) override {
+        return this->statement->bind_int(param, val);
+    }
+    int bind_int64(const int idx, const int64_t val) override {
+        return this->statement->bind_int64(idx, val);
+    }
+    int bind_int64(const std::string& param, const int64_t val) override {
+        return this->statement->bind_int64(param, val);
+    }
+    int bind_double(const int idx, const double val) override {
+        return this->statement->bind_double(idx, val);
+    }
+    int bind_double(const std::string& param, const double val) override {
+        return this->statement->bind_double(param, val);
+    }
+    int bind_null(const int idx) override {
+        return this->statement->bind_null(idx);
+    }
+    int bind_null(const std::string& param) override {
+        return this->statement->bind_null(param);
+    }
+    int get_number_of_rows() override {
+        return this->statement->get_number_of_rows();
+    }
+    int column_type(const int idx) override {
+        return this->statement->column_type(idx);
+    }
+    SqliteVariant column_variant(const std::string& name) override {
+        return this->statement->column_variant(name);
+    }
+    std::string column_text(const int idx) override {
+        return this->statement->column_text(idx);
+    }
+    std::optional<std::string> column_text_nullable(const int idx) override {
+        return this->statement->column_text_nullable(idx);
+    }
+    int column_int(const int idx) override {
+        return this->statement->column_int(idx);
+    }
+    int64_t column_int64(const int idx) override {
+        return this->statement->column_int64(idx);
+    }
+    double column_double(const int idx) override {
+        return this->statement->column_double(idx);
+    }
+};
+
+TEST_F(SQLiteStatementTest, DefaultsForMinimalImplementations) {
+    db->execute("INSERT INTO test_table (name, value) VALUES (?, ?);", "first", 1);
+    MinimalStatement minimal{db->new_statement("SELECT name, score FROM test_table;")};
+    StatementInterface& statement = minimal;
+    ASSERT_EQ(statement.step(), SQLITE_ROW);
+
+    std::string out = "previous";
+    EXPECT_TRUE(statement.column_text_into(0, out));
+    EXPECT_EQ(out, "first");
+    EXPECT_FALSE(statement.column_text_into(1, out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_THROW(statement.column_text_view(0), QueryExecutionException);
+    EXPECT_THROW(statement.column_blob(0), QueryExecutionException);
+
+    const std::vector<std::uint8_t> bytes{1, 2, 3};
+    EXPECT_EQ(statement.bind_blob(1, bytes), SQLITE_MISUSE);
+    EXPECT_EQ(statement.bind_blob(":blob", bytes), SQLITE_MISUSE);
+    EXPECT_EQ(statement.bind_zeroblob(1, 16), SQLITE_MISUSE);
+    EXPECT_EQ(statement.bind_zeroblob(":blob", 16), SQLITE_MISUSE);
+
+    EXPECT_EQ(statement.parameter_index(":name"), 0);
+    EXPECT_THROW(statement.param(":name"), std::out_of_range);
+    EXPECT_EQ(statement.column_index("name"), -1);
+    EXPECT_FALSE(statement.column_blob_copy("name").has_value());
+
+    EXPECT_EQ(statement.stats().runs, 0);
+    EXPECT_EQ(statement.stats().vm_steps, 0);
+}
+
 } // namespace everest::db::sqlite
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+class StatementCacheTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        fs::path db_path = "file::memory:?cache=shared";
+        db = std::make_unique<Connection>(db_path);
+        ASSERT_TRUE(db->open_connection());
+
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE test_table (id INTEGER PRIMARY KEY, name TEXT);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+};
+
+TEST_F(StatementCacheTest, RepeatedStatementIsServedFromCache) {
+    const std::string sql = "SELECT COUNT(*) FROM test_table;";
+    const auto before = db->get_statement_cache_stats();
+
+    {
+        auto stmt = db->new_statement(sql);
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    }
+    {
+        auto stmt = db->new_statement(sql);
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+        EXPECT_EQ(stmt->column_int(0), 0);
+    }
+
+    const auto after = db->get_statement_cache_stats();
+    EXPECT_EQ(after.misses - before.misses, 1);
+    EXPECT_EQ(after.hits - before.hits, 1);
+}
+
+TEST_F(StatementCacheTest, ReleasedStatementIsResetAndUnbound) {
+    const std::string insert_sql = "INSERT INTO test_table (id, name) VALUES (?, ?);";
+    {
+        auto stmt = db->new_statement(insert_sql);
+        stmt->bind_int(1, 1);
+        stmt->bind_text(2, "first", SQLiteString::Transient);
+        ASSERT_EQ(stmt->step(), SQLITE_DONE);
+    }
+    {
+        // Bindings of the previous user must not leak into this one
+        auto stmt = db->new_statement(insert_sql);
+        stmt->bind_int(1, 2);
+        ASSERT_EQ(stmt->step(), SQLITE_DONE);
+    }
+
+    auto select_stmt = db->new_statement("SELECT name FROM test_table WHERE id = 2;");
+    ASSERT_EQ(select_stmt->step(), SQLITE_ROW);
+    EXPECT_FALSE(select_stmt->column_text_nullable(0).has_value());
+}
+
+TEST_F(StatementCacheTest, ConcurrentHandlesForSameSql) {
+    const std::string sql = "SELECT id FROM test_table ORDER BY id;";
+    ASSERT_TRUE(db->execute_statement("INSERT INTO test_table (id, name) VALUES (1, 'a'), (2, 'b');"));
+
+    auto first = db->new_statement(sql);
+    auto second = db->new_statement(sql);
+
+    ASSERT_EQ(first->step(), SQLITE_ROW);
+    ASSERT_EQ(second->step(), SQLITE_ROW);
+    ASSERT_EQ(second->step(), SQLITE_ROW);
+    EXPECT_EQ(first->column_int(0), 1);
+    EXPECT_EQ(second->column_int(0), 2);
+}
+
+TEST_F(StatementCacheTest, LeastRecentlyUsedIsEvicted) {
+    db->set_statement_cache_capacity(2);
+
+    for (int i = 0; i < 3; i++) {
+        auto stmt = db->new_statement("SELECT " + std::to_string(i) + ";");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    }
+
+    auto stats = db->get_statement_cache_stats();
+    EXPECT_EQ(stats.size, 2);
+    EXPECT_EQ(stats.capacity, 2);
+    EXPECT_GE(stats.evictions, 1);
+
+    const auto hits = stats.hits;
+    {
+        auto stmt = db->new_statement("SELECT 0;");
+    }
+    EXPECT_EQ(db->get_statement_cache_stats().hits, hits);
+    {
+        auto stmt = db->new_statement("SELECT 2;");
+    }
+    EXPECT_EQ(db->get_statement_cache_stats().hits, hits + 1);
+}
+
+TEST_F(StatementCacheTest, ZeroCapacityDisablesCache) {
+    db->set_statement_cache_capacity(0);
+    const auto before = db->get_statement_cache_stats();
+
+    for (int i = 0; i < 2; i++) {
+        auto stmt = db->new_statement("SELECT 1;");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    }
+
+    const auto after = db->get_statement_cache_stats();
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.size, 0);
+}
+
+TEST_F(StatementCacheTest, ReopenedConnectionStartsWithEmptyCache) {
+    auto file_db = std::make_unique<Connection>(fs::temp_directory_path() / "statement_cache_test" / "test.db");
+    ASSERT_TRUE(file_db->open_connection());
+    {
+        auto stmt = file_db->new_statement("SELECT 1;");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    }
+    EXPECT_EQ(file_db->get_statement_cache_stats().size, 1);
+
+    ASSERT_TRUE(file_db->close_connection());
+    EXPECT_EQ(file_db->get_statement_cache_stats().size, 0);
+
+    ASSERT_TRUE(file_db->open_connection());
+    {
+        auto stmt = file_db->new_statement("SELECT 1;");
+        ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    }
+    ASSERT_TRUE(file_db->close_connection());
+    fs::remove_all(fs::temp_directory_path() / "statement_cache_test");
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class TransactionModesTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "transaction_modes_test";
+        fs::remove_all(directory);
+        db = std::make_unique<Connection>(directory / "test.db");
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE events (id INTEGER PRIMARY KEY);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+        db.reset();
+        fs::remove_all(directory);
+    }
+
+    /// \brief Opens a second connection to the database, which locks like another process
+    std::unique_ptr<Connection> open_other(const ConnectionOptions& options = {}) {
+        auto other = std::make_unique<Connection>(directory / "test.db", options);
+        EXPECT_TRUE(other->open_connection());
+        return other;
+    }
+
+    std::vector<std::int64_t> ids() {
+        std::vector<std::int64_t> result;
+        auto stmt = db->new_statement("SELECT id FROM events ORDER BY id;");
+        while (stmt->step() == SQLITE_ROW) {
+            result.push_back(stmt->column_int64(0));
+        }
+        return result;
+    }
+};
+
+TEST_F(TransactionModesTest, NestedTransactionsAreSavepoints) {
+    auto outer = db->begin_transaction();
+    db->execute("INSERT INTO events (id) VALUES (1);");
+    {
+        auto committed = db->begin_transaction();
+        db->execute("INSERT INTO events (id) VALUES (2);");
+        committed->commit();
+    }
+    {
+        // Rolled back when destroyed
+        auto rolled_back = db->begin_transaction();
+        db->execute("INSERT INTO events (id) VALUES (3);");
+        auto inner = db->begin_transaction();
+        db->execute("INSERT INTO events (id) VALUES (4);");
+        inner->commit();
+    }
+    outer->commit();
+    EXPECT_EQ(ids(), (std::vector<std::int64_t>{1, 2}));
+}
+
+TEST_F(TransactionModesTest, OuterRollbackUndoesNestedCommits) {
+    auto outer = db->begin_transaction();
+    auto inner = db->begin_transaction();
+    db->execute("INSERT INTO events (id) VALUES (1);");
+    inner->commit();
+    outer->rollback();
+    EXPECT_TRUE(ids().empty());
+
+    // Other threads still wait for the transaction instead of nesting
+    auto transaction = db->begin_transaction();
+    std::thread other([this]() { EXPECT_EQ(db->begin_transaction({TransactionPriority::Normal, 20ms}), nullptr); });
+    other.join();
+}
+
+TEST_F(TransactionModesTest, TruncateTablesInsideTransaction) {
+    db->execute("INSERT INTO events (id) VALUES (1);");
+    auto transaction = db->begin_transaction();
+    EXPECT_EQ(db->truncate_tables({"events"}).rows_deleted, 1);
+    transaction->rollback();
+    EXPECT_EQ(ids(), (std::vector<std::int64_t>{1}));
+}
+
+TEST_F(TransactionModesTest, ImmediateTransactionTakesWriteLock) {
+    auto other = open_other();
+
+    // A deferred transaction doesn't lock anything before its first statement
+    auto deferred = db->begin_transaction();
+    auto immediate = other->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate});
+    immediate->commit();
+    deferred->commit();
+
+    immediate = db->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate});
+    EXPECT_THROW(
+        (void)other->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Exclusive}),
+        QueryExecutionException);
+    immediate->commit();
+
+    // The failed begin released the transaction lock of the other connection
+    auto exclusive = other->begin_transaction({TransactionPriority::Normal, 0ms, TransactionMode::Exclusive});
+    ASSERT_NE(exclusive, nullptr);
+    exclusive->commit();
+}
+
+TEST_F(TransactionModesTest, BusyRetryWaitsForOtherConnection) {
+    ConnectionOptions options;
+    options.busy_retry = BusyRetryOptions{};
+    auto other = open_other(options);
+
+    auto holder = db->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate});
+    std::thread release([&holder]() {
+        std::this_thread::sleep_for(100ms);
+        holder->commit();
+    });
+    auto waiting = other->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate});
+    release.join();
+    other->execute("INSERT INTO events (id) VALUES (1);");
+    waiting->commit();
+
+    const auto stats = other->get_busy_stats();
+    EXPECT_EQ(stats.busy_events, 1);
+    EXPECT_GE(stats.retries, 2);
+    EXPECT_EQ(stats.timeouts, 0);
+    EXPECT_GE(stats.total_wait_time, 50ms);
+    EXPECT_EQ(ids(), (std::vector<std::int64_t>{1}));
+}
+
+TEST_F(TransactionModesTest, BusyRetryGivesUpAfterTimeout) {
+    ConnectionOptions options;
+    options.busy_retry = BusyRetryOptions{};
+    options.busy_retry->timeout = 50ms;
+    auto other = open_other(options);
+
+    auto holder = db->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate});
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(
+        (void)other->begin_transaction({TransactionPriority::Normal, std::nullopt, TransactionMode::Immediate}),
+        QueryExecutionException);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, 50ms);
+    EXPECT_LT(elapsed, 1s);
+
+    const auto stats = other->get_busy_stats();
+    EXPECT_EQ(stats.busy_events, 1);
+    EXPECT_EQ(stats.timeouts, 1);
+    EXPECT_LE(stats.max_wait_time, 100ms);
+    holder->commit();
+}
+
+} // namespace everest::db::sqlite
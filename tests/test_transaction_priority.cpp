@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace everest::db::sqlite {
+
+class TransactionPriorityTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Connection> db;
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+
+    void SetUp() override {
+        db = std::make_unique<Connection>("file:transaction_priority_test?mode=memory&cache=private");
+        ASSERT_TRUE(db->open_connection());
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE events (name TEXT);"));
+    }
+
+    void TearDown() override {
+        db->close_connection();
+    }
+
+    /// \brief Starts a thread that inserts \p name in a transaction with \p priority and records when it got it
+    std::thread start_writer(const std::string& name, TransactionPriority priority) {
+        return std::thread([this, name, priority]() {
+            auto transaction = db->begin_transaction({priority, std::nullopt});
+            ASSERT_NE(transaction, nullptr);
+            db->execute("INSERT INTO events (name) VALUES (?);", name);
+            {
+                const std::lock_guard lock(this->order_mutex);
+                this->order.push_back(name);
+            }
+            transaction->commit();
+        });
+    }
+};
+
+TEST_F(TransactionPriorityTest, TimeoutReturnsNoTransaction) {
+    auto transaction = db->begin_transaction();
+
+    std::thread waiter([this]() {
+        EXPECT_EQ(db->begin_transaction({TransactionPriority::Critical, 50ms}), nullptr);
+    });
+    waiter.join();
+    transaction->commit();
+
+    const auto stats = db->get_transaction_lock_stats();
+    EXPECT_EQ(stats.critical.timeouts, 1);
+    EXPECT_EQ(stats.critical.acquisitions, 0);
+    EXPECT_GE(stats.critical.max_wait_time, 50ms);
+    EXPECT_EQ(stats.normal.acquisitions, 1);
+
+    // The lock is free again
+    auto next = db->begin_transaction({TransactionPriority::Background, 0ms});
+    ASSERT_NE(next, nullptr);
+    next->commit();
+}
+
+TEST_F(TransactionPriorityTest, HigherPrioritiesAreAdmittedFirst) {
+    auto transaction = db->begin_transaction();
+
+    // Queued in reverse order of their priorities
+    auto background = start_writer("background", TransactionPriority::Background);
+    std::this_thread::sleep_for(30ms);
+    auto normal = start_writer("normal", TransactionPriority::Normal);
+    std::this_thread::sleep_for(30ms);
+    auto critical = start_writer("critical", TransactionPriority::Critical);
+    std::this_thread::sleep_for(30ms);
+
+    transaction->commit();
+    background.join();
+    normal.join();
+    critical.join();
+
+    EXPECT_EQ(order, (std::vector<std::string>{"critical", "normal", "background"}));
+    const auto stats = db->get_transaction_lock_stats();
+    EXPECT_EQ(stats.critical.acquisitions, 1);
+    EXPECT_EQ(stats.background.acquisitions, 1);
+    EXPECT_GE(stats.background.max_wait_time, stats.critical.max_wait_time);
+    EXPECT_GE(stats.background.total_wait_time, 90ms);
+}
+
+TEST_F(TransactionPriorityTest, TimedOutWaiterDoesNotBlockLowerPriorities) {
+    auto transaction = db->begin_transaction();
+    std::thread critical(
+        [this]() { EXPECT_EQ(db->begin_transaction({TransactionPriority::Critical, 30ms}), nullptr); });
+    std::this_thread::sleep_for(10ms);
+    auto background = start_writer("background", TransactionPriority::Background);
+    critical.join();
+
+    transaction->commit();
+    background.join();
+    EXPECT_EQ(order, (std::vector<std::string>{"background"}));
+}
+
+TEST_F(TransactionPriorityTest, TransactionsWithOptionsRollBack) {
+    {
+        auto transaction = db->begin_transaction({TransactionPriority::Background, 1s});
+        ASSERT_NE(transaction, nullptr);
+        db->execute("INSERT INTO events (name) VALUES ('rolled back');");
+    }
+    auto stmt = db->new_statement("SELECT COUNT(*) FROM events;");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_EQ(stmt->column_int(0), 0);
+}
+
+} // namespace everest::db::sqlite
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2020 - 2025 Pionix GmbH and Contributors to EVerest
+
+#include <everest/database/sqlite/connection.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace everest::db::sqlite {
+
+class TruncateTablesTest : public ::testing::Test {
+protected:
+    fs::path directory;
+    std::unique_ptr<Connection> db;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() / "truncate_tables_test";
+        fs::remove_all(directory);
+        ConnectionOptions options;
+        options.auto_vacuum = AutoVacuum::Incremental;
+        db = std::make_unique<Connection>(directory / "test.db", options);
+        ASSERT_TRUE(db->open_connection());
+    }
+
+    void TearDown() override {
+        db->close_connection();
+        db.reset();
+        fs::remove_all(directory);
+    }
+
+    std::int64_t query(const std::string& sql) {
+        auto stmt = db->new_statement(sql);
+        EXPECT_EQ(stmt->step(), SQLITE_ROW);
+        return stmt->column_int64(0);
+    }
+
+    void create_table(const std::string& name, int rows) {
+        ASSERT_TRUE(db->execute_statement("CREATE TABLE " + name + " (id INTEGER PRIMARY KEY, data BLOB);"));
+        auto transaction = db->begin_transaction();
+        for (int i = 0; i < rows; i++) {
+            db->execute("INSERT INTO " + name + " (data) VALUES (zeroblob(500));");
+        }
+        transaction->commit();
+    }
+};
+
+TEST_F(TruncateTablesTest, ClearsAllTables) {
+    create_table("meter_values", 100);
+    create_table("\"security events\"", 50);
+
+    const auto result = db->truncate_tables({"meter_values", "security events"});
+    EXPECT_EQ(result.rows_deleted, 150);
+    EXPECT_TRUE(result.slow_tables.empty());
+    EXPECT_EQ(result.pages_vacuumed, 0);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM meter_values;"), 0);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM \"security events\";"), 0);
+}
+
+TEST_F(TruncateTablesTest, TablesWithTriggersAreReported) {
+    create_table("messages", 20);
+    ASSERT_TRUE(db->execute_statement("CREATE TABLE deleted (id INTEGER);"));
+    ASSERT_TRUE(db->execute_statement(
+        "CREATE TRIGGER log_delete AFTER DELETE ON messages BEGIN INSERT INTO deleted VALUES (OLD.id); END;"));
+
+    const auto result = db->truncate_tables({"messages"});
+    EXPECT_EQ(result.rows_deleted, 20);
+    ASSERT_EQ(result.slow_tables.size(), 1);
+    EXPECT_EQ(result.slow_tables.at(0), "messages");
+    EXPECT_EQ(query("SELECT COUNT(*) FROM deleted;"), 20);
+}
+
+TEST_F(TruncateTablesTest, ReferencedTablesAreReported) {
+    ASSERT_TRUE(db->execute_statement("PRAGMA foreign_keys = ON;"));
+    create_table("transactions", 10);
+    ASSERT_TRUE(db->execute_statement(
+        "CREATE TABLE meter_values (id INTEGER PRIMARY KEY, transaction_id INTEGER REFERENCES transactions(id));"));
+    ASSERT_TRUE(db->execute_statement("INSERT INTO meter_values (transaction_id) VALUES (1);"));
+
+    // Both the child and the parent table have to be checked row by row while foreign keys are enforced
+    const auto result = db->truncate_tables({"meter_values", "transactions"});
+    EXPECT_EQ(result.rows_deleted, 11);
+    EXPECT_EQ(result.slow_tables, (std::vector<std::string>{"meter_values", "transactions"}));
+}
+
+TEST_F(TruncateTablesTest, NoTableIsClearedOnError) {
+    create_table("meter_values", 10);
+
+    EXPECT_THROW(db->truncate_tables({"meter_values", "missing"}), QueryExecutionException);
+    EXPECT_EQ(query("SELECT COUNT(*) FROM meter_values;"), 10);
+}
+
+TEST_F(TruncateTablesTest, FreePagesAreVacuumed) {
+    create_table("meter_values", 1000);
+    const auto pages_before = query("PRAGMA page_count;");
+
+    TruncateOptions options;
+    options.vacuum_pages = -1;
+    const auto result = db->truncate_tables({"meter_values"}, options);
+    EXPECT_EQ(result.rows_deleted, 1000);
+    EXPECT_GT(result.pages_vacuumed, 100);
+    EXPECT_EQ(query("PRAGMA freelist_count;"), 0);
+    EXPECT_EQ(query("PRAGMA page_count;"), pages_before - result.pages_vacuumed);
+}
+
+TEST_F(TruncateTablesTest, VacuumIsLimitedToRequestedPages) {
+    create_table("meter_values", 1000);
+
+    TruncateOptions options;
+    options.vacuum_pages = 10;
+    const auto result = db->truncate_tables({"meter_values"}, options);
+    EXPECT_EQ(result.pages_vacuumed, 10);
+    EXPECT_GT(query("PRAGMA freelist_count;"), 0);
+}
+
+} // namespace everest::db::sqlite